@@ -0,0 +1,41 @@
+#include "alloc_stats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Over-aligned forms (std::align_val_t) are left to the standard library;
+// nothing in the game allocates over-aligned types on the heap.
+
+namespace {
+std::atomic<uint64_t> g_allocations{ 0 };
+std::atomic<uint64_t> g_bytes{ 0 };
+
+void* countedAlloc(std::size_t n) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(n, std::memory_order_relaxed);
+    return std::malloc(n ? n : 1);
+}
+} // namespace
+
+uint64_t allocationCount() { return g_allocations.load(std::memory_order_relaxed); }
+uint64_t allocatedBytes() { return g_bytes.load(std::memory_order_relaxed); }
+
+void* operator new(std::size_t n) {
+    void* p = countedAlloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t n) {
+    void* p = countedAlloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
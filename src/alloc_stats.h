@@ -0,0 +1,8 @@
+#pragma once
+#include <cstdint>
+
+// Process-wide heap counters, maintained by the replacement global
+// operator new/delete in alloc_stats.cpp. Cheap relaxed atomics, so they are
+// always on; read them as deltas around the code being measured.
+uint64_t allocationCount(); // calls to operator new (all forms but aligned)
+uint64_t allocatedBytes();  // bytes requested through those calls
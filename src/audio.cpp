@@ -0,0 +1,239 @@
+#include "audio.h"
+#include <algorithm>
+#include <cmath>
+#include "world.h"
+
+namespace {
+
+const float kPi = 3.14159265f;
+const float kReleaseSeconds = 0.01f; // fade applied when a loop is stopped or a one-shot stolen
+
+int roundUpPow2(int v) {
+    int p = 64;
+    while (p < v && p < 8192) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+void AudioEngine::synthesize() {
+    const float rate = static_cast<float>(rate_);
+    Pcg32 rng(0x5eed);
+    auto noise = [&]() { return static_cast<float>(rng()) / 2147483648.0f - 1.0f; };
+
+    // Thrust: low-passed noise with a slow wobble. Half a second, looped;
+    // the filter state is carried around the loop so the seam is quiet.
+    {
+        std::vector<float>& b = pcm_[static_cast<int>(Sfx::Thrust)];
+        b.resize(static_cast<size_t>(rate * 0.5f));
+        float lp = 0.0f;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t i = 0; i < b.size(); ++i) {
+                lp += 0.08f * (noise() - lp);
+                float t = static_cast<float>(i) / rate;
+                b[i] = lp * (0.55f + 0.15f * std::sin(2.0f * kPi * 6.0f * t));
+            }
+        }
+    }
+    // Split: noise crack plus a falling low thump.
+    {
+        std::vector<float>& b = pcm_[static_cast<int>(Sfx::Split)];
+        b.resize(static_cast<size_t>(rate * 0.35f));
+        float phase = 0.0f, lp = 0.0f;
+        for (size_t i = 0; i < b.size(); ++i) {
+            float t = static_cast<float>(i) / rate;
+            float freq = 40.0f + 80.0f * std::exp(-t * 12.0f);
+            phase += 2.0f * kPi * freq / rate;
+            lp += 0.3f * (noise() - lp);
+            b[i] = 0.6f * std::sin(phase) * std::exp(-t * 9.0f) + 0.5f * lp * std::exp(-t * 25.0f);
+        }
+    }
+    // Collision: descending buzzy tone with a noise tail.
+    {
+        std::vector<float>& b = pcm_[static_cast<int>(Sfx::Collision)];
+        b.resize(static_cast<size_t>(rate * 0.6f));
+        float phase = 0.0f;
+        for (size_t i = 0; i < b.size(); ++i) {
+            float t = static_cast<float>(i) / rate;
+            float freq = 110.0f + 330.0f * std::exp(-t * 6.0f);
+            phase += 2.0f * kPi * freq / rate;
+            float tone = std::sin(phase) + 0.3f * std::sin(3.0f * phase);
+            b[i] = (0.45f * tone + 0.25f * noise()) * std::exp(-t * 5.0f);
+        }
+    }
+}
+
+bool AudioEngine::open(int bufferFrames, int sampleRate) {
+    close();
+    rate_ = sampleRate;
+    synthesize();
+
+    SDL_AudioSpec want, have;
+    SDL_zero(want);
+    want.freq = sampleRate;
+    want.format = AUDIO_F32SYS;
+    want.channels = 2;
+    want.samples = static_cast<Uint16>(roundUpPow2(bufferFrames));
+    want.callback = &AudioEngine::callback;
+    want.userdata = this;
+    // no allowed changes: SDL converts to whatever the device wants, so the
+    // mixer always sees stereo float at our rate
+    device_ = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+    if (device_ == 0) {
+        SDL_Log("audio: could not open device: %s", SDL_GetError());
+        return false;
+    }
+    frames_ = have.samples;
+    ticksPerUs_ = static_cast<double>(SDL_GetPerformanceFrequency()) / 1e6;
+    SDL_Log("audio: %s driver, %d Hz, %d frames per buffer (%.1f ms)",
+        SDL_GetCurrentAudioDriver(), rate_, frames_, 1000.0 * frames_ / rate_);
+    SDL_PauseAudioDevice(device_, 0);
+    return true;
+}
+
+void AudioEngine::close() {
+    if (device_ == 0) return;
+    SDL_CloseAudioDevice(device_); // waits for a running callback to return
+    device_ = 0;
+    for (auto& v : voices_) v = Voice();
+    for (auto& v : fading_) v = Voice();
+}
+
+void AudioEngine::push(const Command& c) {
+    if (device_ == 0) return;
+    if (!commands_.push(c)) stats_.commandsDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioEngine::play(Sfx sfx, float gain, float pan) {
+    push({ Command::Play, sfx, gain, pan });
+}
+
+void AudioEngine::setLoop(Sfx sfx, bool on, float gain) {
+    push({ on ? Command::LoopOn : Command::LoopOff, sfx, gain, 0.0f });
+}
+
+void AudioEngine::setMasterGain(float gain) {
+    push({ Command::Master, Sfx::Count, gain, 0.0f });
+}
+
+void AudioEngine::apply(const Command& c) {
+    if (c.type == Command::Master) {
+        master_ = c.gain;
+        return;
+    }
+    const int releaseFrames = std::max(1, static_cast<int>(rate_ * kReleaseSeconds));
+    if (c.type == Command::LoopOff) {
+        for (auto& v : voices_) {
+            if (v.pcm && v.loop && v.sfx == c.sfx && v.release == 0) v.release = releaseFrames;
+        }
+        return;
+    }
+    float pan = std::max(-1.0f, std::min(1.0f, c.pan));
+    float gl = c.gain * std::cos((pan + 1.0f) * kPi * 0.25f);
+    float gr = c.gain * std::sin((pan + 1.0f) * kPi * 0.25f);
+    if (c.type == Command::LoopOn) {
+        for (auto& v : voices_) {
+            if (v.pcm && v.loop && v.sfx == c.sfx && v.release == 0) {
+                v.gainL = gl; v.gainR = gr;
+                return;
+            }
+        }
+    }
+
+    // free voice, else steal the oldest one-shot (loops are never stolen)
+    Voice* slot = nullptr;
+    for (auto& v : voices_) {
+        if (!v.pcm) { slot = &v; break; }
+    }
+    if (!slot) {
+        for (auto& v : voices_) {
+            if (!v.loop && (!slot || v.age < slot->age)) slot = &v;
+        }
+        if (!slot) return;
+        stats_.voicesStolen.fetch_add(1, std::memory_order_relaxed);
+        // the victim fades out from a side slot instead of being cut off,
+        // which would click; reuse whichever side slot is nearest its end
+        Voice* tail = &fading_[0];
+        for (auto& f : fading_) {
+            if (!f.pcm) { tail = &f; break; }
+            if (f.release < tail->release) tail = &f;
+        }
+        *tail = *slot;
+        if (tail->release == 0) tail->release = releaseFrames;
+    }
+    const std::vector<float>& pcm = pcm_[static_cast<int>(c.sfx)];
+    slot->pcm = pcm.data();
+    slot->length = static_cast<uint32_t>(pcm.size());
+    slot->pos = 0;
+    slot->gainL = gl;
+    slot->gainR = gr;
+    slot->loop = c.type == Command::LoopOn;
+    slot->sfx = c.sfx;
+    slot->release = 0;
+    slot->age = nextAge_++;
+}
+
+void AudioEngine::mix(float* out, int frames) {
+    std::fill(out, out + frames * 2, 0.0f);
+    const int releaseFrames = std::max(1, static_cast<int>(rate_ * kReleaseSeconds));
+    Voice* const sets[2] = { voices_, fading_ };
+    for (Voice* set : sets) {
+        for (int vi = 0; vi < kVoices; ++vi) {
+            Voice& v = set[vi];
+            if (!v.pcm) continue;
+            float* o = out;
+            int left = frames;
+            while (left > 0 && v.pcm) {
+                int n = static_cast<int>(std::min<uint32_t>(static_cast<uint32_t>(left), v.length - v.pos));
+                if (v.release > 0) n = std::min(n, v.release);
+                const float* src = v.pcm + v.pos;
+                if (v.release > 0) {
+                    float step = 1.0f / releaseFrames;
+                    float g = v.release * step;
+                    for (int i = 0; i < n; ++i, g -= step) {
+                        o[2 * i] += src[i] * v.gainL * g;
+                        o[2 * i + 1] += src[i] * v.gainR * g;
+                    }
+                    v.release -= n;
+                    if (v.release == 0) { v.pcm = nullptr; break; }
+                } else {
+                    for (int i = 0; i < n; ++i) {
+                        o[2 * i] += src[i] * v.gainL;
+                        o[2 * i + 1] += src[i] * v.gainR;
+                    }
+                }
+                o += 2 * n;
+                left -= n;
+                v.pos += static_cast<uint32_t>(n);
+                if (v.pos >= v.length) {
+                    if (v.loop) v.pos = 0;
+                    else v.pcm = nullptr;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < frames * 2; ++i) {
+        float s = out[i] * master_;
+        out[i] = s < -1.0f ? -1.0f : (s > 1.0f ? 1.0f : s);
+    }
+}
+
+void SDLCALL AudioEngine::callback(void* user, Uint8* stream, int len) {
+    AudioEngine* self = static_cast<AudioEngine*>(user);
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    Command c;
+    while (self->commands_.pop(c)) self->apply(c);
+    int frames = len / static_cast<int>(2 * sizeof(float));
+    self->mix(reinterpret_cast<float*>(stream), frames);
+    Uint64 t1 = SDL_GetPerformanceCounter();
+
+    // single writer: plain load/store on the atomics is enough
+    AudioStats& st = self->stats_;
+    uint64_t us = static_cast<uint64_t>((t1 - t0) / self->ticksPerUs_);
+    uint64_t budgetUs = static_cast<uint64_t>(1e6 * frames / self->rate_);
+    st.callbacks.store(st.callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    st.framesMixed.store(st.framesMixed.load(std::memory_order_relaxed) + frames, std::memory_order_relaxed);
+    st.totalCallbackUs.store(st.totalCallbackUs.load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    if (us > st.worstCallbackUs.load(std::memory_order_relaxed)) st.worstCallbackUs.store(us, std::memory_order_relaxed);
+    if (us > budgetUs) st.deadlineMisses.store(st.deadlineMisses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Sound effects. PCM is synthesized once at startup and never freed while the
+// device is open, so voices can point straight into it.
+enum class Sfx : uint8_t {
+    Thrust,    // looped while thrusting
+    Split,     // asteroid broke in two
+    Collision, // ship hit an asteroid
+    Count
+};
+
+// Counters shared with the audio thread. All but commandsDropped are written
+// only by the callback.
+struct AudioStats {
+    std::atomic<uint64_t> callbacks{ 0 };
+    std::atomic<uint64_t> framesMixed{ 0 };
+    std::atomic<uint64_t> deadlineMisses{ 0 }; // callback took longer than its buffer plays
+    std::atomic<uint64_t> commandsDropped{ 0 }; // ring full (counted by the game thread)
+    std::atomic<uint64_t> voicesStolen{ 0 };
+    std::atomic<uint64_t> worstCallbackUs{ 0 };
+    std::atomic<uint64_t> totalCallbackUs{ 0 };
+};
+
+// Single-producer / single-consumer ring of fixed-size commands. The game
+// thread pushes, the audio callback pops; neither side locks or allocates.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+public:
+    bool push(const T& v) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N) return false;
+        buf_[head & (N - 1)] = v;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& out) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = buf_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+private:
+    T buf_[N];
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+};
+
+// Fixed voice pool mixed in the SDL audio callback (stereo float32).
+// Works with any SDL audio driver, including `dummy` and `disk`
+// (SDL_AUDIODRIVER=dummy), which is how mixing cost and deadline misses are
+// measured headless.
+class AudioEngine {
+public:
+    static const int kVoices = 16;
+
+    AudioEngine() = default;
+    ~AudioEngine() { close(); }
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+
+    // Open the default device with `bufferFrames` sample frames per callback
+    // (rounded to a power of two; 256 = ~5.3ms at 48kHz). Requires
+    // SDL_INIT_AUDIO. Returns false if no device could be opened; the other
+    // calls are then no-ops.
+    bool open(int bufferFrames = 256, int sampleRate = 48000);
+    void close();
+    bool isOpen() const { return device_ != 0; }
+
+    // Game thread API: queue commands for the callback. Never blocks.
+    void play(Sfx sfx, float gain = 1.0f, float pan = 0.0f);
+    void setLoop(Sfx sfx, bool on, float gain = 1.0f); // one looping voice per effect
+    void setMasterGain(float gain);
+
+    const AudioStats& stats() const { return stats_; }
+    int sampleRate() const { return rate_; }
+    int bufferFrames() const { return frames_; }
+
+private:
+    struct Command {
+        enum Type : uint8_t { Play, LoopOn, LoopOff, Master } type;
+        Sfx sfx;
+        float gain;
+        float pan;
+    };
+    struct Voice {
+        const float* pcm = nullptr; // mono
+        uint32_t length = 0;
+        uint32_t pos = 0;
+        float gainL = 0.0f, gainR = 0.0f;
+        bool loop = false;
+        int release = 0; // frames left in the fade-out, 0 = not releasing
+        Sfx sfx = Sfx::Count;
+        uint32_t age = 0; // start order, for stealing the oldest voice
+    };
+
+    static void SDLCALL callback(void* user, Uint8* stream, int len);
+    void mix(float* out, int frames);
+    void apply(const Command& c);
+    void push(const Command& c);
+    void synthesize();
+
+    SDL_AudioDeviceID device_ = 0;
+    int rate_ = 48000;
+    int frames_ = 256;
+    std::vector<float> pcm_[static_cast<int>(Sfx::Count)];
+    SpscRing<Command, 256> commands_;
+    // callback-owned state
+    Voice voices_[kVoices];
+    Voice fading_[kVoices]; // stolen one-shots finishing their release
+    uint32_t nextAge_ = 0;
+    float master_ = 0.8f;
+    double ticksPerUs_ = 1.0;
+    AudioStats stats_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "world.h"
+
+// Visible part of the world: top-left corner in world space plus size.
+struct ViewRect {
+    float x, y;
+    float w, h;
+};
+
+// Pick the image of a wrapped coordinate that overlaps [0, span). Prefers the
+// canonical image (same as wrap(), so nothing moves when the view is at the
+// origin) and falls back to the one shifted left/up by the world size.
+static inline bool pickWrappedImage(float d, float r, float span, float worldSpan, float& out) {
+    d = wrap(d, 0.0f, worldSpan);
+    if (d - r < span) { out = d; return true; }
+    if (d - worldSpan + r > 0.0f) { out = d - worldSpan; return true; }
+    return false;
+}
+
+// Toroidal bounding-circle test against the view, using the same wrap bounds
+// as the simulation ([0, worldW) x [0, worldH)). On success `screen` is the
+// circle centre relative to the view's top-left corner.
+static inline bool circleInView(Vec2 p, float r, const ViewRect& view, float worldW, float worldH, Vec2& screen) {
+    float sx, sy;
+    if (!pickWrappedImage(p.x - view.x, r, view.w, worldW, sx)) return false;
+    if (!pickWrappedImage(p.y - view.y, r, view.h, worldH, sy)) return false;
+    screen = { sx, sy };
+    return true;
+}
+
+// Polygon level of detail: vertex stride for drawing a `verts`-gon whose
+// on-screen radius is `screenR`, keeping the chord error (sagitta) under
+// about 0.75px. Returns 0 when the shape is small enough to be a single point.
+// With today's fixed zoom only rocks a few pixels across (dense scenario
+// fields) are reduced; the in-game sizes always draw every vertex.
+static inline int lodStride(float screenR, size_t verts) {
+    const float maxError = 0.75f;
+    if (screenR < 2.0f * maxError) return 0;
+    // sagitta r*(1-cos(pi/n)) ~= r*pi^2/(2n^2) <= maxError
+    size_t need = static_cast<size_t>(std::ceil(3.14159265f * std::sqrt(screenR / (2.0f * maxError))));
+    need = std::max<size_t>(need, 3);
+    if (need >= verts) return 1;
+    // largest stride that still draws at least `need` vertices
+    return static_cast<int>((verts - 1) / (need - 1));
+}
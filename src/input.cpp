@@ -0,0 +1,79 @@
+#include "input.h"
+#include <algorithm>
+
+bool mapControlKey(int scancode, InputKey& out) {
+    switch (scancode) {
+    case SDL_SCANCODE_LEFT: out = KeyRotateLeft; return true;
+    case SDL_SCANCODE_RIGHT: out = KeyRotateRight; return true;
+    case SDL_SCANCODE_UP: out = KeyThrust; return true;
+    default: return false;
+    }
+}
+
+void InputTimeline::reset(Uint32 nowMs) {
+    windowStart_ = nowMs;
+    pending_.clear();
+    for (int k = 0; k < KeyCount; ++k) {
+        down_[k] = false;
+        held_[k] = 0.0f;
+    }
+}
+
+void InputTimeline::onEvent(const SDL_Event& ev) {
+    if (ev.type != SDL_KEYDOWN && ev.type != SDL_KEYUP) return;
+    if (ev.key.repeat) return;
+    InputKey key;
+    if (!mapControlKey(ev.key.keysym.scancode, key)) return;
+    pending_.push_back({ ev.key.timestamp, key, ev.type == SDL_KEYDOWN });
+}
+
+void InputTimeline::advance(Uint32 nowMs) {
+    const Uint32 start = windowStart_;
+    const Uint32 span = nowMs - start; // unsigned: survives SDL_GetTicks wrap
+    Uint32 heldMs[KeyCount] = {};
+    Uint32 since[KeyCount];
+    for (int k = 0; k < KeyCount; ++k) since[k] = 0;
+
+    // events arrive in timestamp order; clamp into the window in case the
+    // clock and the stamps disagree by a tick
+    for (const Transition& t : pending_) {
+        Uint32 at = t.timestamp - start;
+        if (at > span) at = (static_cast<Sint32>(at) < 0) ? 0 : span;
+        // a press and release inside the same millisecond still counts as 1ms
+        if (down_[t.key] && !t.down) heldMs[t.key] += std::max<Uint32>(1, at - since[t.key]);
+        since[t.key] = at;
+        down_[t.key] = t.down;
+    }
+    pending_.clear();
+
+    for (int k = 0; k < KeyCount; ++k) {
+        if (down_[k]) heldMs[k] += span - since[k];
+        held_[k] = span > 0 ? std::min(1.0f, static_cast<float>(heldMs[k]) / span) : (down_[k] ? 1.0f : 0.0f);
+    }
+    windowStart_ = nowMs;
+}
+
+void InputLatencyProbe::onEvent(const SDL_Event& ev) {
+    if (ev.type != SDL_KEYDOWN || ev.key.repeat) return;
+    InputKey key;
+    if (!mapControlKey(ev.key.keysym.scancode, key)) return;
+    pending_.push_back(ev.key.timestamp);
+}
+
+void InputLatencyProbe::onPresent(Uint32 nowMs) {
+    for (Uint32 ts : pending_) {
+        Uint32 ms = nowMs - ts;
+        SDL_Log("latency: event->present %u ms", ms);
+        ++samples_;
+        totalMs_ += ms;
+        minMs_ = std::min(minMs_, ms);
+        maxMs_ = std::max(maxMs_, ms);
+    }
+    pending_.clear();
+}
+
+void InputLatencyProbe::report() const {
+    if (samples_ == 0) return;
+    SDL_Log("latency: %u inputs, event->present min %u ms, avg %.1f ms, max %u ms",
+        samples_, minMs_, totalMs_ / samples_, maxMs_);
+}
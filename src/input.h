@@ -0,0 +1,66 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// Ship controls tracked with sub-frame timing.
+enum InputKey {
+    KeyRotateLeft,
+    KeyRotateRight,
+    KeyThrust,
+    KeyCount
+};
+
+// Control bound to `scancode`, if any.
+bool mapControlKey(int scancode, InputKey& out);
+
+// Records key transitions with their SDL event timestamps and, for each
+// frame, works out how much of the frame each control was actually held.
+// A press late in a frame only counts for the part of the frame after it,
+// and a tap that starts and ends between two polls still registers.
+// Timestamps are SDL_GetTicks() milliseconds, the same clock SDL stamps
+// events with.
+class InputTimeline {
+public:
+    // Start the first frame window at `nowMs`.
+    void reset(Uint32 nowMs);
+    // Feed every polled event; non-control events are ignored.
+    void onEvent(const SDL_Event& ev);
+    // Close the window [previous advance, nowMs] and compute held fractions.
+    // Call after draining the event queue.
+    void advance(Uint32 nowMs);
+
+    // Fraction (0..1) of the last window the key was held.
+    float heldFraction(InputKey key) const { return held_[key]; }
+    // Held at the end of the last window, or at any point during it.
+    bool active(InputKey key) const { return down_[key] || held_[key] > 0.0f; }
+
+private:
+    struct Transition {
+        Uint32 timestamp;
+        InputKey key;
+        bool down;
+    };
+    Uint32 windowStart_ = 0;
+    bool down_[KeyCount] = {};
+    float held_[KeyCount] = {};
+    std::vector<Transition> pending_;
+};
+
+// Latency probe: remembers control key presses and, after the frame that
+// first reflects them is presented, reports event-to-present time. Presses
+// are timed from their SDL timestamp, i.e. when the main loop pumped them.
+class InputLatencyProbe {
+public:
+    void onEvent(const SDL_Event& ev);
+    // Call right after SDL_RenderPresent.
+    void onPresent(Uint32 nowMs);
+    // Log min/avg/max over all samples.
+    void report() const;
+
+private:
+    std::vector<Uint32> pending_;
+    Uint32 samples_ = 0;
+    Uint32 minMs_ = 0xffffffffu;
+    Uint32 maxMs_ = 0;
+    double totalMs_ = 0.0;
+};
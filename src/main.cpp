@@ -4,8 +4,22 @@
 #include <chrono>
 #include <random>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include "world.h"
+#include "snapshot.h"
+#include "cull.h"
+#include "physics.h"
+#include "audio.h"
+#include "input.h"
+#include "scenario.h"
+#include "telemetry.h"
+#include "alloc_stats.h"
+#include "softraster.h"
 #if defined(__has_include)
 #  if __has_include(<SDL_ttf.h>)
 #    include <SDL_ttf.h>
@@ -17,28 +31,30 @@
 struct TTF_Font;
 #endif
 
-struct Vec2 {
-    float x;
-    float y;
-};
+// Thin wrappers over the SDL draw calls so every frame's draw-call count is
+// known (scenario reports, stats).
+static uint64_t g_drawCalls = 0;
 
-static float wrap(float v, float a, float b) {
-    float w = b - a;
-    while (v < a) v += w;
-    while (v >= b) v -= w;
-    return v;
-}
+static int fillRect(SDL_Renderer* r, const SDL_Rect* rect) { ++g_drawCalls; return SDL_RenderFillRect(r, rect); }
+static int drawLine(SDL_Renderer* r, int x1, int y1, int x2, int y2) { ++g_drawCalls; return SDL_RenderDrawLine(r, x1, y1, x2, y2); }
+static int drawLines(SDL_Renderer* r, const SDL_Point* pts, int n) { ++g_drawCalls; return SDL_RenderDrawLines(r, pts, n); }
+static int drawPoint(SDL_Renderer* r, int x, int y) { ++g_drawCalls; return SDL_RenderDrawPoint(r, x, y); }
+static int copyTexture(SDL_Renderer* r, SDL_Texture* tex, const SDL_Rect* src, const SDL_Rect* dst) { ++g_drawCalls; return SDL_RenderCopy(r, tex, src, dst); }
 
-void drawPolygon(SDL_Renderer* r, const std::vector<Vec2>& pts, int tx = 0, int ty = 0) {
-    if (pts.size() < 2) return;
-    std::vector<SDL_Point> spts(pts.size() + 1);
-    for (size_t i = 0; i < pts.size(); ++i) {
+void drawPolygon(SDL_Renderer* r, const Vec2* pts, size_t n, int tx = 0, int ty = 0) {
+    if (n < 2) return;
+    std::vector<SDL_Point> spts(n + 1);
+    for (size_t i = 0; i < n; ++i) {
         spts[i].x = static_cast<int>(pts[i].x + tx);
         spts[i].y = static_cast<int>(pts[i].y + ty);
     }
-    spts[pts.size()].x = static_cast<int>(pts[0].x + tx);
-    spts[pts.size()].y = static_cast<int>(pts[0].y + ty);
-    SDL_RenderDrawLines(r, spts.data(), static_cast<int>(spts.size()));
+    spts[n].x = static_cast<int>(pts[0].x + tx);
+    spts[n].y = static_cast<int>(pts[0].y + ty);
+    drawLines(r, spts.data(), static_cast<int>(spts.size()));
+}
+
+void drawPolygon(SDL_Renderer* r, const std::vector<Vec2>& pts, int tx = 0, int ty = 0) {
+    drawPolygon(r, pts.data(), pts.size(), tx, ty);
 }
 
 // Simple filled triangle rasterizer (scanline) for small UI/flame effects.
@@ -59,82 +75,158 @@ static void drawFilledTriangle(SDL_Renderer* r, Vec2 p0, Vec2 p1, Vec2 p2) {
             float xl = interpX(p0, p1, (float)y);
             float xr = interpX(p0, p2, (float)y);
             if (xl > xr) std::swap(xl, xr);
-            SDL_RenderDrawLine(r, static_cast<int>(xl), y, static_cast<int>(xr), y);
+            drawLine(r, static_cast<int>(xl), y, static_cast<int>(xr), y);
         } else {
             float xl = interpX(p1, p2, (float)y);
             float xr = interpX(p0, p2, (float)y);
             if (xl > xr) std::swap(xl, xr);
-            SDL_RenderDrawLine(r, static_cast<int>(xl), y, static_cast<int>(xr), y);
+            drawLine(r, static_cast<int>(xl), y, static_cast<int>(xr), y);
         }
     }
 }
 
-struct Asteroid {
-    Vec2 pos;
-    std::vector<Vec2> shape; // relative
-    float radius; // approximate collision radius
-    Vec2 vel{0.0f, 0.0f};
-};
-
-// Visual event: short bright spark (pop) and moving shooting star
-struct Spark {
-    Vec2 pos;
-    float life = 0.0f;
-    float maxLife = 0.2f;
-    float size = 2.0f;
+// Startup timeline: milliseconds since process start, logged as each step
+// finishes so a slow step is visible even if startup never completes.
+struct StartupTimeline {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double mark(const char* step) const {
+        std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+        SDL_Log("startup: %-14s %8.2f ms", step, ms.count());
+        return ms.count();
+    }
 };
 
-struct ShootingStar {
-    Vec2 pos;
-    Vec2 vel;
-    float life = 0.0f;
-    float maxLife = 1.2f;
-    float length = 40.0f; // trail length
+// Per-second render counters, printed when stats are on (--stats or F3).
+struct FrameStats {
+    int frames = 0;
+    float seconds = 0.0f;
+    long long astDrawn = 0, astCulled = 0, astPoints = 0, astVerts = 0;
+    long long sparksDrawn = 0, sparksCulled = 0;
+    long long shootDrawn = 0, shootCulled = 0;
+    long long contacts = 0, islands = 0;
 };
 
 int main(int argc, char** argv) {
-    (void)argc; (void)argv;
+    StartupTimeline startup;
+    bool statsEnabled = false;
+    int worldArgW = 0, worldArgH = 0;
+    int physicsThreads = 0; // 0 = one per hardware thread
+    bool audioEnabled = true;
+    int audioBufferFrames = 256; // ~5ms at 48kHz
+    bool latencyMode = false;
+    std::string scenarioNames; // --scenario=name[,name...]|all
+    int scenarioTicks = 600;
+    double soakMinutes = 0.0;
+    std::string scenarioOut;
+    std::string telemetryName; // --telemetry[=SEGMENT]
+    bool softRasterEnabled = true;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stats") == 0) statsEnabled = true;
+        // --world=WxH makes the wrap-around world larger than the window;
+        // the view then follows the ship
+        else if (strncmp(argv[i], "--world=", 8) == 0) sscanf(argv[i] + 8, "%dx%d", &worldArgW, &worldArgH);
+        else if (strncmp(argv[i], "--threads=", 10) == 0) physicsThreads = atoi(argv[i] + 10);
+        else if (strcmp(argv[i], "--no-audio") == 0) audioEnabled = false;
+        else if (strcmp(argv[i], "--latency") == 0) latencyMode = true;
+        else if (strncmp(argv[i], "--audio-buffer=", 15) == 0) audioBufferFrames = atoi(argv[i] + 15);
+        else if (strncmp(argv[i], "--scenario=", 11) == 0) scenarioNames = argv[i] + 11;
+        else if (strncmp(argv[i], "--ticks=", 8) == 0) scenarioTicks = atoi(argv[i] + 8);
+        else if (strncmp(argv[i], "--soak-minutes=", 15) == 0) soakMinutes = atof(argv[i] + 15);
+        else if (strncmp(argv[i], "--out=", 6) == 0) scenarioOut = argv[i] + 6;
+        else if (strcmp(argv[i], "--telemetry") == 0) telemetryName = kTelemetryDefaultName;
+        else if (strncmp(argv[i], "--telemetry=", 12) == 0) telemetryName = argv[i] + 12;
+        else if (strcmp(argv[i], "--no-soft-raster") == 0) softRasterEnabled = false;
+    }
+    ScenarioRunner scenario;
+    if (!scenarioNames.empty() && !scenario.configure(scenarioNames, scenarioTicks, soakMinutes, scenarioOut)) return 2;
     if (SDL_Init(SDL_INIT_VIDEO) != 0) return -1;
+    startup.mark("sdl init");
 #ifdef HAVE_SDL_TTF
     if (TTF_Init() != 0) {
         // Continue without TTF if initialization fails; we'll handle missing font gracefully
     }
+    startup.mark("ttf init");
 #endif
 
     const int W = 800, H = 600;
+    // world bounds used by wrap(); defaults to the window size
+    const float worldW = static_cast<float>(worldArgW >= W ? worldArgW : W);
+    const float worldH = static_cast<float>(worldArgH >= H ? worldArgH : H);
     SDL_Window* win = SDL_CreateWindow("Starboy - prototype",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
         W, H, SDL_WINDOW_SHOWN);
     if (!win) return -1;
+    startup.mark("window");
     SDL_Renderer* ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED);
+    // software fallback keeps headless runs (SDL_VIDEODRIVER=dummy) working
+    if (!ren) ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_SOFTWARE);
     if (!ren) return -1;
+    startup.mark("renderer");
 
+    // Show something immediately; fonts and the world are prepared after this.
+    SDL_SetRenderDrawColor(ren, 8, 8, 20, 255);
+    SDL_RenderClear(ren);
+    SDL_RenderPresent(ren);
+    startup.mark("blank present");
+    bool firstFrameShown = false; // time-to-first-frame is marked after the first game frame
+
+    // Sound (optional): a missing audio device never stops the game
+    AudioEngine audio;
+    if (audioEnabled) {
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) == 0) audio.open(audioBufferFrames);
+        else SDL_Log("audio: init failed: %s", SDL_GetError());
+        startup.mark("audio");
+    }
+    bool thrustSoundOn = false;
+
+    // Filled shapes (asteroid bodies, thrust flame) go through the CPU
+    // rasterizer; without it the flame falls back to scanline lines
+    SoftRaster raster;
+    if (softRasterEnabled && !raster.init(ren, W, H))
+        SDL_Log("softraster: streaming texture unavailable: %s", SDL_GetError());
+    bool asteroidFill = true; // F4
+
+    // All simulated state lives in `world` so it can be snapshotted; the
+    // references keep the game code below reading as before.
+    World world;
     // Ship
-    Vec2 shipPos{ static_cast<float>(W) / 2.0f, static_cast<float>(H) / 2.0f };
-    float shipAngle = 0.0f; // radians
-    Vec2 shipVel{ 0.0f, 0.0f };
+    Vec2& shipPos = world.shipPos;
+    float& shipAngle = world.shipAngle;
+    Vec2& shipVel = world.shipVel;
+    shipPos = { worldW / 2.0f, worldH / 2.0f };
 
-    // TTF font (optional)
-#ifdef HAVE_SDL_TTF
+    // TTF font (optional), opened on a background thread. `font` stays null
+    // until the loader publishes it, so the menu draws its rectangle
+    // placeholders meanwhile. FreeType is only touched by the loader until
+    // then, and only by this thread afterwards.
     TTF_Font* font = nullptr;
-    const char* fontCandidates[] = {
+#ifdef HAVE_SDL_TTF
+    static const char* fontCandidates[] = {
+#ifdef _WIN32
         "C:/Windows/Fonts/segui.ttf",
         "C:/Windows/Fonts/SegoeUI.ttf",
         "C:/Windows/Fonts/arial.ttf",
+#endif
         "./assets/DejaVuSans.ttf",
         NULL
     };
     const char* loadedFontPath = nullptr;
-    for (int i = 0; fontCandidates[i] != NULL; ++i) {
-        font = TTF_OpenFont(fontCandidates[i], 24);
-        if (font) { loadedFontPath = fontCandidates[i]; break; }
-    }
+    TTF_Font* loaderFont = nullptr;
+    std::atomic<bool> fontLoaderDone{ false };
+    std::thread fontLoader([&]() {
+        for (int i = 0; fontCandidates[i] != NULL; ++i) {
+            loaderFont = TTF_OpenFont(fontCandidates[i], 24);
+            if (loaderFont) { loadedFontPath = fontCandidates[i]; break; }
+        }
+        fontLoaderDone.store(true, std::memory_order_release);
+    });
 #else
-    TTF_Font* font = nullptr; // stub when TTF not available
+    bool fontLoaderDone = true; // stub when TTF not available
 #endif
+    bool fontPending = true;
 
     // Asteroids - simple fixed ones
-    std::vector<Asteroid> asts;
+    std::vector<Asteroid>& asts = world.asts;
     // Background stars (non-colliding visual layer)
     std::vector<Vec2> stars;
     std::vector<int> starBase;
@@ -143,10 +235,11 @@ int main(int argc, char** argv) {
     std::vector<float> starTwinklePhase;
     std::vector<float> starTwinkleAmp;
     // runtime visual events
-    std::vector<Spark> sparks;
-    std::vector<ShootingStar> shootingStars;
-    // RNG for runtime events (non-deterministic)
-    std::mt19937 runtimeRng(static_cast<unsigned>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
+    std::vector<Spark>& sparks = world.sparks;
+    std::vector<ShootingStar>& shootingStars = world.shootingStars;
+    // RNG for runtime events (non-deterministic seed, but part of the snapshot)
+    Pcg32& runtimeRng = world.rng;
+    runtimeRng.reseed(static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
 
     auto createAsteroids = [&](std::vector<Asteroid>& out) {
         out.clear();
@@ -236,9 +329,10 @@ int main(int argc, char** argv) {
             starTwinkleAmp.push_back(amp);
         }
     }
+    startup.mark("worldgen");
 
     auto restartGame = [&](void) {
-        shipPos = { static_cast<float>(W) / 2.0f, static_cast<float>(H) / 2.0f };
+        shipPos = { worldW / 2.0f, worldH / 2.0f };
         shipAngle = 0.0f;
         shipVel = { 0.0f, 0.0f };
         createAsteroids(asts);
@@ -280,8 +374,8 @@ int main(int argc, char** argv) {
         if (!ofs) return;
         ofs << starTwinklePreset << " " << (shootingStarsEnabled ? 1 : 0);
     };
-    // load persisted settings (if any)
-    loadSettings();
+    // load persisted settings (if any); scenarios always run with defaults
+    if (!scenario.active()) loadSettings();
 
     auto renderText = [&](SDL_Renderer* r, TTF_Font* f, const char* text, SDL_Color col, int& outW, int& outH)->SDL_Texture* {
         outW = outH = 0;
@@ -302,7 +396,86 @@ int main(int argc, char** argv) {
     auto last = std::chrono::high_resolution_clock::now();
     // collision / gameplay state
     const float shipRadius = 14.0f; // used for simple collision test
-    float collisionFlash = 0.0f; // seconds to show collision flash
+    float& collisionFlash = world.collisionFlash;
+    FrameStats frameStats;
+    AsteroidPhysics physics(physicsThreads > 0 ? static_cast<unsigned>(physicsThreads) : 0u);
+    std::vector<Vec2> lodPts; // reused asteroid outline buffer
+    // outlines of filled asteroids, drawn once the fill layer is down
+    std::vector<Vec2> outlinePts;
+    std::vector<size_t> outlineSizes;
+    // Rewind history (hold Backspace) and quick save/load (F5/F9)
+    SnapshotRing rewindRing;
+    const std::string snapshotFilePath = "starboy_snapshot.bin";
+    // Controls are applied for the part of each frame they were held
+    InputTimeline input;
+    input.reset(SDL_GetTicks());
+    InputLatencyProbe latencyProbe; // --latency
+    const float targetFrameSeconds = 1.0f / 60.0f;
+    // --telemetry: live counters for external monitors (starboy_telemetry)
+    TelemetryWriter telemetry;
+    if (!telemetryName.empty()) {
+        if (telemetry.open(telemetryName.c_str())) SDL_Log("telemetry: publishing to %s", telemetryName.c_str());
+        else SDL_Log("telemetry: cannot create %s (in use by another game?)", telemetryName.c_str());
+    }
+    uint64_t frameCount = 0;
+
+    // --scenario: every scene starts from the same world and RNG state and
+    // runs on a virtual clock, so only the frame times differ between runs
+    Uint32 scenarioMs = 0;
+    bool scenarioKeys[KeyCount] = {};
+    auto setupScenario = [&](ScenarioKind kind) {
+        restartGame();
+        if (kind == ScenarioKind::Empty) asts.clear(); // ship only
+        sparks.clear();
+        shootingStars.clear();
+        collisionFlash = 0.0f;
+        world.tick = 0;
+        rewindRing.clear();
+        runtimeRng.reseed(0x5eed5eedull);
+        scenarioMs = 0;
+        for (bool& down : scenarioKeys) down = false;
+        input.reset(scenarioMs);
+        menuOpen = false;
+        inSettings = false;
+        if (kind == ScenarioKind::Asteroids1k || kind == ScenarioKind::Asteroids10k) {
+            const int count = kind == ScenarioKind::Asteroids1k ? 1000 : 10000;
+            Pcg32 fieldRng;
+            fieldRng.reseed(42);
+            std::uniform_real_distribution<float> u(0.0f, 1.0f);
+            asts.clear();
+            asts.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                Asteroid a;
+                a.pos = { u(fieldRng) * worldW, u(fieldRng) * worldH };
+                const int verts = 8;
+                float rradius = 4.0f + u(fieldRng) * 8.0f;
+                float maxr = 0.0f;
+                for (int v = 0; v < verts; ++v) {
+                    float ang = static_cast<float>(v) / verts * 2.0f * 3.14159265f;
+                    float rr = rradius * (0.8f + 0.4f * u(fieldRng));
+                    a.shape.push_back({ std::cos(ang) * rr, std::sin(ang) * rr });
+                    maxr = std::max(maxr, rr);
+                }
+                a.radius = maxr;
+                a.vel = { (u(fieldRng) - 0.5f) * 40.0f, (u(fieldRng) - 0.5f) * 40.0f };
+                asts.push_back(std::move(a));
+            }
+        }
+        if (kind == ScenarioKind::MenuTtf) {
+#ifdef HAVE_SDL_TTF
+            // measure with the font in place, not the placeholder boxes
+            if (fontPending) {
+                fontLoader.join();
+                font = loaderFont;
+                fontPending = false;
+            }
+#endif
+            menuOpen = true;
+        }
+        scenario.start();
+    };
+    if (scenario.active()) setupScenario(scenario.current().kind);
+
     bool running = true;
     while (running) {
         auto now = std::chrono::high_resolution_clock::now();
@@ -310,10 +483,31 @@ int main(int argc, char** argv) {
         last = now;
         float dt = dtf.count();
         if (dt > 0.05f) dt = 0.05f;
+        if (scenario.active()) {
+            dt = targetFrameSeconds;
+            scenarioMs += 16 + (scenario.tick() % 3 == 0 ? 1 : 0); // ~1000/60
+        }
+        g_drawCalls = 0;
+        const uint64_t frameStartAllocs = allocationCount();
+
+        // pick up the font once the background loader is finished
+        if (fontPending && fontLoaderDone) {
+            fontPending = false;
+#ifdef HAVE_SDL_TTF
+            fontLoader.join();
+            font = loaderFont;
+            if (font) SDL_Log("startup: font %s", loadedFontPath);
+            else SDL_Log("startup: no TTF font found, using menu placeholders");
+            startup.mark("font ready");
+#endif
+        }
 
         SDL_Event ev;
         while (SDL_PollEvent(&ev)) {
             if (ev.type == SDL_QUIT) running = false;
+            if (scenario.active()) continue; // scripted input only
+            input.onEvent(ev);
+            if (latencyMode) latencyProbe.onEvent(ev);
 
                 if (ev.type == SDL_MOUSEBUTTONDOWN) {
                 // menu icon area (top-left 40x24)
@@ -411,57 +605,108 @@ int main(int argc, char** argv) {
                 // quick keyboard shortcuts
                 if (ev.key.keysym.sym == SDLK_r) restartGame();
                 if (ev.key.keysym.sym == SDLK_q) running = false;
+                if (ev.key.keysym.sym == SDLK_F3) statsEnabled = !statsEnabled;
+                if (ev.key.keysym.sym == SDLK_F4) asteroidFill = !asteroidFill;
+                // quick save / quick load of the whole world
+                if (ev.key.keysym.sym == SDLK_F5) {
+                    if (!saveSnapshotFile(snapshotFilePath, world))
+                        SDL_Log("snapshot: failed to save %s", snapshotFilePath.c_str());
+                }
+                if (ev.key.keysym.sym == SDLK_F9) {
+                    if (!loadSnapshotFile(snapshotFilePath, world))
+                        SDL_Log("snapshot: failed to load %s", snapshotFilePath.c_str());
+                }
             }
         }
 
+        if (scenario.active()) {
+            // feed the scripted controls through the same timestamped path
+            // as real key events, half way into the frame
+            bool want[KeyCount];
+            scenarioInput(scenario.tick(), want[KeyRotateLeft], want[KeyRotateRight], want[KeyThrust]);
+            const SDL_Scancode codes[KeyCount] = { SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT, SDL_SCANCODE_UP };
+            for (int key = 0; key < KeyCount; ++key) {
+                if (want[key] == scenarioKeys[key]) continue;
+                scenarioKeys[key] = want[key];
+                SDL_Event sev;
+                SDL_zero(sev);
+                sev.type = want[key] ? SDL_KEYDOWN : SDL_KEYUP;
+                sev.key.timestamp = scenarioMs - 8;
+                sev.key.keysym.scancode = codes[key];
+                input.onEvent(sev);
+            }
+            const ScenarioKind kind = scenario.current().kind;
+            if (kind == ScenarioKind::Splitting) {
+                if (asts.size() < 4) createAsteroids(asts);
+                shipPos = asts.front().pos; // collide (and split) every tick
+            }
+            input.advance(scenarioMs);
+        } else {
+            input.advance(SDL_GetTicks());
+        }
         const Uint8* k = SDL_GetKeyboardState(NULL);
-        if (k[SDL_SCANCODE_LEFT]) shipAngle -= 3.0f * dt;
-        if (k[SDL_SCANCODE_RIGHT]) shipAngle += 3.0f * dt;
-        if (k[SDL_SCANCODE_UP]) {
-            float thrust = 200.0f * dt;
-            // forward vector for local (0,-1) after rotation by shipAngle:
-            float fx = std::sin(shipAngle);
-            float fy = -std::cos(shipAngle);
-            shipVel.x += fx * thrust;
-            shipVel.y += fy * thrust;
-        }
-
-        // Drag
-        shipVel.x *= 0.995f;
-        shipVel.y *= 0.995f;
-
-        shipPos.x += shipVel.x * dt;
-        shipPos.y += shipVel.y * dt;
-        shipPos.x = wrap(shipPos.x, 0.0f, static_cast<float>(W));
-        shipPos.y = wrap(shipPos.y, 0.0f, static_cast<float>(H));
-
-        // Simple collision detection: ship vs asteroid (circle-circle approx)
-        for (int i = static_cast<int>(asts.size()) - 1; i >= 0; --i) {
-            const Asteroid a = asts[i];
-            float dx = shipPos.x - a.pos.x;
-            float dy = shipPos.y - a.pos.y;
-            float dist2 = dx*dx + dy*dy;
-            float r = shipRadius + a.radius;
-            if (dist2 <= r * r) {
-                // Collision occurred: split asteroid if large enough, otherwise remove
-                std::vector<Asteroid> children;
-                splitAsteroid(a, children);
-                // erase the original
-                asts.erase(asts.begin() + i);
-                // if children produced, set small velocities for them
-                for (size_t ci = 0; ci < children.size(); ++ci) {
-                    // velocity roughly perpendicular to offset direction
-                    float vx = (ci == 0) ? -40.0f : 40.0f;
-                    float vy = (ci == 0) ? -24.0f : 24.0f;
-                    children[ci].vel.x = vx;
-                    children[ci].vel.y = vy;
-                    asts.push_back(std::move(children[ci]));
+        // Rewind: step back one recorded tick per frame while Backspace is held.
+        // The restored state is shown as-is, so the frame runs with dt = 0.
+        bool rewinding = false;
+        if (k[SDL_SCANCODE_BACKSPACE] && !menuOpen) {
+            rewinding = rewindRing.popLatest(world);
+            if (rewinding) dt = 0.0f;
+        }
+        // A rewound frame only shows the restored state: nothing below may
+        // advance it (drag, collisions, or draws from the runtime rng), so
+        // play resumes from exactly the recorded snapshot.
+        if (!rewinding) {
+            shipAngle -= 3.0f * dt * input.heldFraction(KeyRotateLeft);
+            shipAngle += 3.0f * dt * input.heldFraction(KeyRotateRight);
+            if (input.heldFraction(KeyThrust) > 0.0f) {
+                float thrust = 200.0f * dt * input.heldFraction(KeyThrust);
+                // forward vector for local (0,-1) after rotation by shipAngle:
+                float fx = std::sin(shipAngle);
+                float fy = -std::cos(shipAngle);
+                shipVel.x += fx * thrust;
+                shipVel.y += fy * thrust;
+            }
+
+            // Drag
+            shipVel.x *= 0.995f;
+            shipVel.y *= 0.995f;
+
+            shipPos.x += shipVel.x * dt;
+            shipPos.y += shipVel.y * dt;
+            shipPos.x = wrap(shipPos.x, 0.0f, worldW);
+            shipPos.y = wrap(shipPos.y, 0.0f, worldH);
+
+            // Simple collision detection: ship vs asteroid (circle-circle approx)
+            for (int i = static_cast<int>(asts.size()) - 1; i >= 0; --i) {
+                const Asteroid a = asts[i];
+                float dx = shipPos.x - a.pos.x;
+                float dy = shipPos.y - a.pos.y;
+                float dist2 = dx*dx + dy*dy;
+                float r = shipRadius + a.radius;
+                if (dist2 <= r * r) {
+                    // Collision occurred: split asteroid if large enough, otherwise remove
+                    std::vector<Asteroid> children;
+                    splitAsteroid(a, children);
+                    float pan = a.pos.x / worldW * 2.0f - 1.0f;
+                    audio.play(Sfx::Collision, 0.9f, pan);
+                    if (!children.empty()) audio.play(Sfx::Split, 0.8f, pan);
+                    // erase the original
+                    asts.erase(asts.begin() + i);
+                    // if children produced, set small velocities for them
+                    for (size_t ci = 0; ci < children.size(); ++ci) {
+                        // velocity roughly perpendicular to offset direction
+                        float vx = (ci == 0) ? -40.0f : 40.0f;
+                        float vy = (ci == 0) ? -24.0f : 24.0f;
+                        children[ci].vel.x = vx;
+                        children[ci].vel.y = vy;
+                        asts.push_back(std::move(children[ci]));
+                    }
+                    // reset ship
+                    shipPos = { worldW / 2.0f, worldH / 2.0f };
+                    shipVel = { 0.0f, 0.0f };
+                    collisionFlash = 0.6f;
+                    break; // handle one collision per frame
                 }
-                // reset ship
-                shipPos = { static_cast<float>(W) / 2.0f, static_cast<float>(H) / 2.0f };
-                shipVel = { 0.0f, 0.0f };
-                collisionFlash = 0.6f;
-                break; // handle one collision per frame
             }
         }
 
@@ -469,8 +714,29 @@ int main(int argc, char** argv) {
         SDL_SetRenderDrawColor(ren, 8, 8, 20, 255);
         SDL_RenderClear(ren);
 
+        // View into the wrap-around world: fixed at the origin while the
+        // world fits the window, otherwise centred on the ship.
+        ViewRect view{ 0.0f, 0.0f, static_cast<float>(W), static_cast<float>(H) };
+        if (worldW > view.w || worldH > view.h) {
+            view.x = shipPos.x - view.w / 2.0f;
+            view.y = shipPos.y - view.h / 2.0f;
+        }
+
+        // particle-storm scenario: a steady flood of sparks on top of the usual ones
+        if (!rewinding && scenario.active() && scenario.current().kind == ScenarioKind::ParticleStorm) {
+            std::uniform_real_distribution<float> pr(0.0f, 1.0f);
+            for (int i = 0; i < 200; ++i) {
+                Spark s;
+                s.pos = { pr(runtimeRng) * worldW, pr(runtimeRng) * worldH };
+                s.maxLife = 0.15f + pr(runtimeRng) * 0.12f;
+                s.size = 2.0f + static_cast<int>(pr(runtimeRng) * 3.0f);
+                s.life = 0.0f;
+                sparks.push_back(s);
+            }
+        }
+
         // Spawn occasional sparks and rare shooting stars
-        {
+        if (!rewinding) {
             std::uniform_real_distribution<float> pr(0.0f, 1.0f);
             // spark spawn rate (per second)
             const float sparkRate = 0.8f; // average ~0.8 sparks/sec
@@ -479,8 +745,8 @@ int main(int argc, char** argv) {
             float pSpark = sparkRate * dt;
             float pShoot = shootRate * dt;
             if (pr(runtimeRng) < pSpark) {
-                std::uniform_real_distribution<float> rx(0.0f, static_cast<float>(W));
-                std::uniform_real_distribution<float> ry(0.0f, static_cast<float>(H));
+                std::uniform_real_distribution<float> rx(0.0f, worldW);
+                std::uniform_real_distribution<float> ry(0.0f, worldH);
                 Spark s; s.pos = { rx(runtimeRng), ry(runtimeRng) };
                 s.maxLife = 0.15f + (pr(runtimeRng) * 0.12f);
                 s.size = 2.0f + static_cast<int>(pr(runtimeRng) * 3.0f);
@@ -557,10 +823,10 @@ int main(int argc, char** argv) {
                 SDL_SetRenderDrawColor(ren, col, col, 230, std::max(0, std::min(255, alpha)));
 
                 if (size <= 1) {
-                    SDL_RenderDrawPoint(ren, static_cast<int>(sx), static_cast<int>(sy));
+                    drawPoint(ren, static_cast<int>(sx), static_cast<int>(sy));
                 } else {
                     SDL_Rect r{ static_cast<int>(sx) - size/2, static_cast<int>(sy) - size/2, size, size };
-                    SDL_RenderFillRect(ren, &r);
+                    fillRect(ren, &r);
                 }
             }
             SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_NONE);
@@ -573,13 +839,16 @@ int main(int argc, char** argv) {
                 s.life += dt;
                 float t = s.life / s.maxLife;
                 if (t >= 1.0f) { sparks.erase(sparks.begin() + i); continue; }
+                int sz = static_cast<int>(s.size + (1.0f - t) * 2.0f);
+                Vec2 sp;
+                if (!circleInView(s.pos, static_cast<float>(sz), view, worldW, worldH, sp)) { ++frameStats.sparksCulled; continue; }
+                ++frameStats.sparksDrawn;
                 float alpha = static_cast<float>(1.0f - t);
                 int a = static_cast<int>(200.0f * alpha) + 55;
                 SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
                 SDL_SetRenderDrawColor(ren, 255, 220, 100, std::max(0, std::min(255, a)));
-                int sz = static_cast<int>(s.size + (1.0f - t) * 2.0f);
-                SDL_Rect r{ static_cast<int>(s.pos.x) - sz/2, static_cast<int>(s.pos.y) - sz/2, sz, sz };
-                SDL_RenderFillRect(ren, &r);
+                SDL_Rect r{ static_cast<int>(sp.x) - sz/2, static_cast<int>(sp.y) - sz/2, sz, sz };
+                fillRect(ren, &r);
                 SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_NONE);
             }
         }
@@ -593,6 +862,14 @@ int main(int argc, char** argv) {
                 // advance
                 ss.pos.x += ss.vel.x * dt;
                 ss.pos.y += ss.vel.y * dt;
+                // shooting stars live in screen space (sky effect): cull the
+                // head+trail bounding circle against the window, no wrap
+                float reach = ss.length + 2.0f;
+                if (ss.pos.x + reach < 0.0f || ss.pos.x - reach >= W || ss.pos.y + reach < 0.0f || ss.pos.y - reach >= H) {
+                    ++frameStats.shootCulled;
+                    continue;
+                }
+                ++frameStats.shootDrawn;
                 float lifeFrac = 1.0f - ss.life / ss.maxLife; // 1..0
 
                 // draw trail: multiple segments backwards along velocity
@@ -605,13 +882,13 @@ int main(int argc, char** argv) {
                     int col = 255 - static_cast<int>(80.0f * segT);
                     SDL_SetRenderDrawColor(ren, col, col, 220, std::max(0, std::min(255, a)));
                     SDL_Rect rr{ static_cast<int>(px) - 2, static_cast<int>(py) - 1, 4, 2 };
-                    SDL_RenderFillRect(ren, &rr);
+                    fillRect(ren, &rr);
                 }
                 // head bright
                 int headAlpha = static_cast<int>(255.0f * lifeFrac);
                 SDL_SetRenderDrawColor(ren, 255, 240, 200, std::max(0, std::min(255, headAlpha)));
                 SDL_Rect head{ static_cast<int>(ss.pos.x) - 2, static_cast<int>(ss.pos.y) - 2, 4, 4 };
-                SDL_RenderFillRect(ren, &head);
+                fillRect(ren, &head);
                 SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_NONE);
             }
         }
@@ -623,56 +900,73 @@ int main(int argc, char** argv) {
             if (pi == starTwinklePreset) SDL_SetRenderDrawColor(ren, 255, 220, 40, 255);
             else SDL_SetRenderDrawColor(ren, 120, 120, 140, 255);
             SDL_Rect d{ baseX + pi * 18, dotY, 10, 10 };
-            SDL_RenderFillRect(ren, &d);
+            fillRect(ren, &d);
         }
         // debug strong indicator (small square)
         if (starTwinkleDebug) SDL_SetRenderDrawColor(ren, 60, 200, 80, 255);
         else SDL_SetRenderDrawColor(ren, 80, 80, 80, 255);
         SDL_Rect dbg{ W - 18, 6, 12, 12 };
-        SDL_RenderFillRect(ren, &dbg);
+        fillRect(ren, &dbg);
+
+        // Update asteroids (all of them, visible or not), bouncing off each other
+        physics.step(asts, dt, worldW, worldH);
+        frameStats.contacts += physics.stats().contacts;
+        frameStats.islands += physics.stats().islands;
 
-        // Draw asteroids
+        // Draw asteroids: cull against the view, then reduce vertex count by size
         SDL_SetRenderDrawColor(ren, 180, 180, 160, 255);
-        for (auto &a : asts) {
-            // update position
-            a.pos.x += a.vel.x * dt;
-            a.pos.y += a.vel.y * dt;
-            a.pos.x = wrap(a.pos.x, 0.0f, static_cast<float>(W));
-            a.pos.y = wrap(a.pos.y, 0.0f, static_cast<float>(H));
-            std::vector<Vec2> absPts;
-            absPts.reserve(a.shape.size());
-            for (const auto& p : a.shape) {
-                absPts.push_back({p.x + a.pos.x, p.y + a.pos.y});
+        const bool fillAsteroids = asteroidFill && raster.ready();
+        outlinePts.clear();
+        outlineSizes.clear();
+        for (const auto &a : asts) {
+            Vec2 sp;
+            if (!circleInView(a.pos, a.radius, view, worldW, worldH, sp)) { ++frameStats.astCulled; continue; }
+            ++frameStats.astDrawn;
+            int stride = lodStride(a.radius, a.shape.size());
+            if (stride == 0) {
+                ++frameStats.astPoints;
+                drawPoint(ren, static_cast<int>(sp.x), static_cast<int>(sp.y));
+                continue;
+            }
+            lodPts.clear();
+            for (size_t v = 0; v < a.shape.size(); v += stride) {
+                lodPts.push_back({ a.shape[v].x + sp.x, a.shape[v].y + sp.y });
+            }
+            frameStats.astVerts += static_cast<long long>(lodPts.size());
+            if (fillAsteroids) {
+                raster.fillPolygon(lodPts.data(), lodPts.size(), sp, SDL_Color{ 60, 58, 52, 255 });
+                outlinePts.insert(outlinePts.end(), lodPts.begin(), lodPts.end());
+                outlineSizes.push_back(lodPts.size());
+            } else {
+                drawPolygon(ren, lodPts);
             }
-            drawPolygon(ren, absPts);
         }
 
         // collision flash overlay (brief)
         if (collisionFlash > 0.0f) {
-            SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
             int alpha = static_cast<int>(std::min(255.0f, collisionFlash / 0.6f * 220.0f));
-            SDL_SetRenderDrawColor(ren, 220, 60, 60, alpha);
-            SDL_Rect full{0,0,W,H};
-            SDL_RenderFillRect(ren, &full);
-            SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_NONE);
+            if (raster.ready()) {
+                // into the fill layer, so it tints the asteroid bodies and
+                // the thrust flame queued next stays on top of it
+                const SDL_Color red{ 220, 60, 60, static_cast<Uint8>(alpha) };
+                const Vec2 tl{ 0.0f, 0.0f }, tr{ static_cast<float>(W), 0.0f };
+                const Vec2 bl{ 0.0f, static_cast<float>(H) }, br{ static_cast<float>(W), static_cast<float>(H) };
+                raster.fillTriangle(tl, tr, br, red, false);
+                raster.fillTriangle(tl, br, bl, red, false);
+            } else {
+                SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+                SDL_SetRenderDrawColor(ren, 220, 60, 60, alpha);
+                SDL_Rect full{0,0,W,H};
+                fillRect(ren, &full);
+                SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_NONE);
+            }
             // decrease timer
             collisionFlash -= dt;
             if (collisionFlash < 0.0f) collisionFlash = 0.0f;
         }
 
-        // Draw a small menu icon (top-left)
-        SDL_SetRenderDrawColor(ren, 120, 120, 140, 255);
-        SDL_Rect menuRect{6, 6, 28, 12};
-        SDL_RenderFillRect(ren, &menuRect);
-        // draw hamburger lines
-        SDL_SetRenderDrawColor(ren, 200, 200, 220, 255);
-        for (int i = 0; i < 3; ++i) {
-            int y = 8 + i * 4;
-            SDL_RenderDrawLine(ren, 10, y, 30, y);
-        }
-
-        // Draw ship as a simple starship shape (nose + wings + rear)
-        SDL_SetRenderDrawColor(ren, 220, 220, 255, 255);
+        // Draw ship as a simple starship shape (nose + wings + rear); the
+        // outline goes on last, over the fill layer
         std::vector<Vec2> shipPts;
         float sr = 14.0f;
         // Define local points (nose-up coordinate system)
@@ -686,20 +980,25 @@ int main(int argc, char** argv) {
             {  sr * 0.6f, -sr * 0.3f }  // right upper
         };
 
-        // Rotate and translate local points into world space.
+        // Rotate and translate local points into screen space.
         // Use the same `shipAngle` as the rotation so nose and thrust align.
+        Vec2 shipScr{ wrap(shipPos.x - view.x, 0.0f, worldW), wrap(shipPos.y - view.y, 0.0f, worldH) };
         float rot = shipAngle;
         float cr = std::cos(rot);
         float srn = std::sin(rot);
         shipPts.reserve(local.size());
         for (const auto& p : local) {
-            float x = cr * p.x - srn * p.y + shipPos.x;
-            float y = srn * p.x + cr * p.y + shipPos.y;
+            float x = cr * p.x - srn * p.y + shipScr.x;
+            float y = srn * p.x + cr * p.y + shipScr.y;
             shipPts.push_back({ x, y });
         }
 
         // Thrust flame (draw behind the ship when UP is pressed)
-        bool thrusting = k[SDL_SCANCODE_UP];
+        bool thrusting = input.active(KeyThrust);
+        if (thrusting != thrustSoundOn) {
+            audio.setLoop(Sfx::Thrust, thrusting, 0.5f);
+            thrustSoundOn = thrusting;
+        }
         if (thrusting) {
             float t = SDL_GetTicks() * 0.001f;
             float flick = (std::sin(t * 30.0f) * 0.5f + 0.5f) * 6.0f;
@@ -711,23 +1010,50 @@ int main(int argc, char** argv) {
             std::vector<Vec2> flamePts;
             flamePts.reserve(flameLocal.size());
             for (const auto& p : flameLocal) {
-                float x = cr * p.x - srn * p.y + shipPos.x;
-                float y = srn * p.x + cr * p.y + shipPos.y;
+                float x = cr * p.x - srn * p.y + shipScr.x;
+                float y = srn * p.x + cr * p.y + shipScr.y;
                 flamePts.push_back({ x, y });
             }
             // outer glow
-            SDL_SetRenderDrawColor(ren, 255, 120, 20, 255);
-            drawFilledTriangle(ren, flamePts[1], flamePts[0], flamePts[2]);
+            if (raster.ready()) {
+                raster.fillTriangle(flamePts[1], flamePts[0], flamePts[2], SDL_Color{ 255, 120, 20, 255 });
+            } else {
+                SDL_SetRenderDrawColor(ren, 255, 120, 20, 255);
+                drawFilledTriangle(ren, flamePts[1], flamePts[0], flamePts[2]);
+            }
             // inner core (smaller, brighter)
             std::vector<Vec2> corePts;
             corePts.reserve(3);
             for (const auto& fp : flamePts) {
-                corePts.push_back({ shipPos.x + (fp.x - shipPos.x) * 0.5f, shipPos.y + (fp.y - shipPos.y) * 0.5f });
+                corePts.push_back({ shipScr.x + (fp.x - shipScr.x) * 0.5f, shipScr.y + (fp.y - shipScr.y) * 0.5f });
+            }
+            if (raster.ready()) {
+                raster.fillTriangle(corePts[1], corePts[0], corePts[2], SDL_Color{ 255, 220, 40, 255 });
+            } else {
+                SDL_SetRenderDrawColor(ren, 255, 220, 40, 255);
+                drawFilledTriangle(ren, corePts[1], corePts[0], corePts[2]);
             }
-            SDL_SetRenderDrawColor(ren, 255, 220, 40, 255);
-            drawFilledTriangle(ren, corePts[1], corePts[0], corePts[2]);
         }
 
+        // One upload + copy for every filled shape queued above, then the
+        // outlines of the filled asteroids on top
+        if (raster.present(ren)) ++g_drawCalls;
+        SDL_SetRenderDrawColor(ren, 180, 180, 160, 255);
+        for (size_t i = 0, first = 0; i < outlineSizes.size(); first += outlineSizes[i++])
+            drawPolygon(ren, outlinePts.data() + first, outlineSizes[i]);
+
+        // Draw a small menu icon (top-left)
+        SDL_SetRenderDrawColor(ren, 120, 120, 140, 255);
+        SDL_Rect menuRect{6, 6, 28, 12};
+        fillRect(ren, &menuRect);
+        // draw hamburger lines
+        SDL_SetRenderDrawColor(ren, 200, 200, 220, 255);
+        for (int i = 0; i < 3; ++i) {
+            int y = 8 + i * 4;
+            drawLine(ren, 10, y, 30, y);
+        }
+
+        SDL_SetRenderDrawColor(ren, 220, 220, 255, 255);
         drawPolygon(ren, shipPts);
 
         // If menu is open, render overlay and menu items on top
@@ -736,7 +1062,7 @@ int main(int argc, char** argv) {
             SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
             SDL_SetRenderDrawColor(ren, 0, 0, 0, 160);
             SDL_Rect full{0,0,W,H};
-            SDL_RenderFillRect(ren, &full);
+            fillRect(ren, &full);
 
             int menuW = 320;
             int padding = 18;
@@ -747,7 +1073,7 @@ int main(int argc, char** argv) {
             int my = (H - menuH) / 2;
             SDL_SetRenderDrawColor(ren, 30, 30, 40, 220);
             SDL_Rect box{mx, my, menuW, menuH};
-            SDL_RenderFillRect(ren, &box);
+            fillRect(ren, &box);
 
             // Draw items
             SDL_Color white{240,240,240,255};
@@ -760,13 +1086,13 @@ int main(int argc, char** argv) {
                     if ((int)i == menuSelection) {
                         SDL_SetRenderDrawColor(ren, 60, 60, 80, 200);
                         SDL_Rect h{ix-8, iy-6, menuW - padding*2 + 16, itemH+8};
-                        SDL_RenderFillRect(ren, &h);
+                        fillRect(ren, &h);
                     }
                     // draw a small arrow indicator for selection (even without font)
                     if ((int)i == menuSelection) {
                         SDL_SetRenderDrawColor(ren, 255, 220, 40, 255);
-                        SDL_RenderDrawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 - 6);
-                        SDL_RenderDrawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 + 6);
+                        drawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 - 6);
+                        drawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 + 6);
                     }
                     // render text if font available
                     int tw = 0, th = 0;
@@ -779,13 +1105,13 @@ int main(int argc, char** argv) {
                             txt = renderText(ren, font, menuItems[i], yellow, tw, th);
                             dst.w = tw; dst.h = th;
                         }
-                        SDL_RenderCopy(ren, txt, NULL, &dst);
+                        copyTexture(ren, txt, NULL, &dst);
                         SDL_DestroyTexture(txt);
                     } else {
                         // fallback: draw label rectangle
                         SDL_SetRenderDrawColor(ren, 120, 120, 140, 255);
                         SDL_Rect lbl{ ix+10, iy + (itemH/4), 140, itemH/2 };
-                        SDL_RenderFillRect(ren, &lbl);
+                        fillRect(ren, &lbl);
                     }
                 }
             } else {
@@ -796,13 +1122,13 @@ int main(int argc, char** argv) {
                     if ((int)i == settingsSelection) {
                         SDL_SetRenderDrawColor(ren, 60, 60, 80, 200);
                         SDL_Rect h{ix-8, iy-6, menuW - padding*2 + 16, itemH+8};
-                        SDL_RenderFillRect(ren, &h);
+                        fillRect(ren, &h);
                     }
                     // draw arrow for selection
                     if ((int)i == settingsSelection) {
                         SDL_SetRenderDrawColor(ren, 255, 220, 40, 255);
-                        SDL_RenderDrawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 - 6);
-                        SDL_RenderDrawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 + 6);
+                        drawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 - 6);
+                        drawLine(ren, ix - 14, iy + itemH/2, ix - 6, iy + itemH/2 + 6);
                     }
                     // prepare label (dynamic for shooting stars)
                     std::string label;
@@ -819,12 +1145,12 @@ int main(int argc, char** argv) {
                             SDL_DestroyTexture(txt);
                             txt = renderText(ren, font, label.c_str(), yellow, tw, th);
                         }
-                        SDL_RenderCopy(ren, txt, NULL, &dst);
+                        copyTexture(ren, txt, NULL, &dst);
                         SDL_DestroyTexture(txt);
                     } else {
                         SDL_SetRenderDrawColor(ren, 120, 120, 140, 255);
                         SDL_Rect lbl{ ix+10, iy + (itemH/4), 140, itemH/2 };
-                        SDL_RenderFillRect(ren, &lbl);
+                        fillRect(ren, &lbl);
                     }
                 }
             }
@@ -834,17 +1160,110 @@ int main(int argc, char** argv) {
         }
 
         SDL_RenderPresent(ren);
+        if (latencyMode) latencyProbe.onPresent(SDL_GetTicks());
+        if (!firstFrameShown) {
+            // includes worldgen and everything else before the first game frame
+            firstFrameShown = true;
+            SDL_Log("startup: time-to-first-frame %.2f ms", startup.mark("first frame"));
+        }
 
-        // Cap ~60fps
-        SDL_Delay(16);
+        // once a second: print render counters (averaged per frame)
+        ++frameStats.frames;
+        frameStats.seconds += dtf.count();
+        if (frameStats.seconds >= 1.0f) {
+            if (statsEnabled) {
+                double n = frameStats.frames;
+                SDL_Log("stats: %.1f fps | asteroids %zu: drawn %.0f culled %.0f point-lod %.0f verts %.0f | sparks drawn %.0f culled %.0f | shooting stars drawn %.0f culled %.0f | contacts %.0f islands %.0f (%u threads)",
+                    n / frameStats.seconds, asts.size(),
+                    frameStats.astDrawn / n, frameStats.astCulled / n, frameStats.astPoints / n, frameStats.astVerts / n,
+                    frameStats.sparksDrawn / n, frameStats.sparksCulled / n,
+                    frameStats.shootDrawn / n, frameStats.shootCulled / n,
+                    frameStats.contacts / n, frameStats.islands / n, physics.stats().threads);
+            }
+            frameStats = FrameStats();
+        }
+
+        // record the finished tick for rewind
+        if (!rewinding) {
+            ++world.tick;
+            rewindRing.push(world);
+        }
+
+        auto workEnd = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<float> spent = workEnd - now;
+        if (telemetry.isOpen()) {
+            TelemetrySample ts;
+            ts.frame = ++frameCount;
+            ts.tick = world.tick;
+            ts.timestampUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+            ts.frameUs = static_cast<uint32_t>(dtf.count() * 1e6f);
+            ts.workUs = static_cast<uint32_t>(spent.count() * 1e6f);
+            ts.asteroids = static_cast<uint32_t>(asts.size());
+            ts.sparks = static_cast<uint32_t>(sparks.size());
+            ts.shootingStars = static_cast<uint32_t>(shootingStars.size());
+            ts.drawCalls = static_cast<uint32_t>(g_drawCalls);
+            ts.allocations = allocationCount();
+            ts.frameAllocations = static_cast<uint32_t>(ts.allocations - frameStartAllocs);
+            ts.audioDeadlineMisses = static_cast<uint32_t>(audio.stats().deadlineMisses.load(std::memory_order_relaxed));
+            ts.shootingStarsEnabled = shootingStarsEnabled;
+            ts.starTwinklePreset = static_cast<uint8_t>(starTwinklePreset);
+            ts.statsEnabled = statsEnabled;
+            ts.menuOpen = menuOpen;
+            telemetry.publish(ts);
+        }
+
+        if (scenario.active()) {
+            std::chrono::duration<double, std::milli> frameMs = workEnd - now;
+            if (scenario.recordFrame(frameMs.count(), g_drawCalls, asts.size(), sparks.size(), shootingStars.size())) {
+                if (scenario.next()) setupScenario(scenario.current().kind);
+                else running = false;
+            }
+            continue; // run flat out, no frame cap
+        }
+
+        // Cap ~60fps: sleep only for what is left of this frame's budget.
+        // SDL stamps key events when they are pumped, so pump in 1ms slices
+        // while waiting: a press during the wait then keeps its real time
+        // inside the next frame's input window instead of being stamped at
+        // the next frame's poll and counting for almost none of it.
+        const auto frameDeadline = now + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+            std::chrono::duration<float>(targetFrameSeconds));
+        for (;;) {
+            SDL_PumpEvents();
+            std::chrono::duration<float, std::milli> left = frameDeadline - std::chrono::high_resolution_clock::now();
+            if (left.count() < 1.0f) break;
+            SDL_Delay(1);
+        }
+    }
+    latencyProbe.report();
+    int exitCode = 0;
+    if (!scenarioNames.empty()) {
+        // an interrupted run still reports the scenarios that finished
+        if (!scenario.writeResults()) exitCode = 1;
     }
 
 #ifdef HAVE_SDL_TTF
+    if (fontLoader.joinable()) {
+        fontLoader.join();
+        font = loaderFont;
+    }
     if (font) TTF_CloseFont(font);
     TTF_Quit();
 #endif
+    if (audio.isOpen()) {
+        const AudioStats& as = audio.stats();
+        uint64_t cbs = as.callbacks.load();
+        SDL_Log("audio: %llu callbacks, %llu frames mixed, avg %.1f us, worst %llu us, %llu deadline misses, %llu dropped commands, %llu stolen voices",
+            (unsigned long long)cbs, (unsigned long long)as.framesMixed.load(),
+            cbs ? static_cast<double>(as.totalCallbackUs.load()) / cbs : 0.0,
+            (unsigned long long)as.worstCallbackUs.load(), (unsigned long long)as.deadlineMisses.load(),
+            (unsigned long long)as.commandsDropped.load(), (unsigned long long)as.voicesStolen.load());
+        audio.close();
+    }
+    raster.shutdown();
     SDL_DestroyRenderer(ren);
     SDL_DestroyWindow(win);
     SDL_Quit();
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,215 @@
+#include "physics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float kRestitution = 1.0f;   // elastic bounces
+const int kVelocityIterations = 4; // sequential-impulse passes per island
+const float kPushOut = 0.8f;       // fraction of overlap removed per step
+const float kSlop = 0.05f;         // overlap tolerated without push-out
+const size_t kBroadphaseChunk = 256; // bodies per broadphase work item
+const uint32_t kNone = 0xffffffffu;
+
+// shortest signed distance from a to b on a wrapped axis of length `span`
+inline float wrapDelta(float d, float span) {
+    if (d > span * 0.5f) d -= span;
+    else if (d < -span * 0.5f) d += span;
+    return d;
+}
+
+// the distinct cells among c-1, c, c+1 on a wrapped axis of `n` cells
+inline int neighbourCells(int c, int n, int out[3]) {
+    if (n == 1) { out[0] = 0; return 1; }
+    if (n == 2) { out[0] = c; out[1] = c ^ 1; return 2; }
+    out[0] = (c + n - 1) % n;
+    out[1] = c;
+    out[2] = (c + 1) % n;
+    return 3;
+}
+
+} // namespace
+
+AsteroidPhysics::AsteroidPhysics(unsigned threads) : pool_(threads) {
+    stats_.threads = pool_.threads();
+}
+
+void AsteroidPhysics::step(std::vector<Asteroid>& asts, float dt, float worldW, float worldH) {
+    stats_.contacts = 0;
+    stats_.islands = 0;
+    if (dt <= 0.0f || asts.empty()) return;
+
+    const size_t n = asts.size();
+    bodies_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Asteroid& a = asts[i];
+        Body& b = bodies_[i];
+        b.x = wrap(a.pos.x + a.vel.x * dt, 0.0f, worldW);
+        b.y = wrap(a.pos.y + a.vel.y * dt, 0.0f, worldH);
+        b.vx = a.vel.x;
+        b.vy = a.vel.y;
+        b.r = a.radius;
+        b.invMass = a.radius > 0.0f ? 1.0f / (a.radius * a.radius) : 0.0f;
+    }
+
+    findContacts(worldW, worldH);
+    if (!contacts_.empty()) {
+        buildIslands();
+        std::function<void(size_t)> solve = [&](size_t k) { solveIsland(k, worldW, worldH); };
+        pool_.run(islandStart_.size() - 1, solve);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const Body& b = bodies_[i];
+        asts[i].pos = { wrap(b.x, 0.0f, worldW), wrap(b.y, 0.0f, worldH) };
+        asts[i].vel = { b.vx, b.vy };
+    }
+}
+
+void AsteroidPhysics::findContacts(float worldW, float worldH) {
+    const size_t n = bodies_.size();
+    float maxR = 0.0f;
+    for (const Body& b : bodies_) maxR = std::max(maxR, b.r);
+    // cells at least one max-diameter wide: any overlapping pair is then in
+    // the same or an adjacent cell
+    const float cellSize = std::max(2.0f * maxR, 1.0f);
+    const int gw = std::max(1, static_cast<int>(worldW / cellSize));
+    const int gh = std::max(1, static_cast<int>(worldH / cellSize));
+    const float cw = worldW / gw, ch = worldH / gh;
+
+    // counting sort of bodies into cells; items stay in index order per cell
+    cellOf_.resize(n);
+    cellStart_.assign(static_cast<size_t>(gw) * gh + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        int cx = std::min(gw - 1, static_cast<int>(bodies_[i].x / cw));
+        int cy = std::min(gh - 1, static_cast<int>(bodies_[i].y / ch));
+        cellOf_[i] = static_cast<uint32_t>(cy * gw + cx);
+        ++cellStart_[cellOf_[i] + 1];
+    }
+    for (size_t c = 1; c < cellStart_.size(); ++c) cellStart_[c] += cellStart_[c - 1];
+    cellItems_.resize(n);
+    cursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (size_t i = 0; i < n; ++i) cellItems_[cursor_[cellOf_[i]]++] = static_cast<uint32_t>(i);
+
+    // narrowphase over fixed-size index chunks; concatenating the chunks in
+    // order gives the same contact list however the chunks were scheduled
+    const size_t chunks = (n + kBroadphaseChunk - 1) / kBroadphaseChunk;
+    if (chunkContacts_.size() < chunks) chunkContacts_.resize(chunks);
+    std::function<void(size_t)> scan = [&](size_t chunk) {
+        std::vector<Contact>& out = chunkContacts_[chunk];
+        out.clear();
+        const size_t end = std::min(n, (chunk + 1) * kBroadphaseChunk);
+        for (size_t i = chunk * kBroadphaseChunk; i < end; ++i) {
+            const Body& bi = bodies_[i];
+            int xs[3], ys[3];
+            int nx = neighbourCells(static_cast<int>(cellOf_[i] % gw), gw, xs);
+            int ny = neighbourCells(static_cast<int>(cellOf_[i] / gw), gh, ys);
+            for (int yi = 0; yi < ny; ++yi) {
+                for (int xi = 0; xi < nx; ++xi) {
+                    size_t cell = static_cast<size_t>(ys[yi]) * gw + xs[xi];
+                    for (uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k) {
+                        uint32_t j = cellItems_[k];
+                        if (j <= i) continue;
+                        const Body& bj = bodies_[j];
+                        float dx = wrapDelta(bj.x - bi.x, worldW);
+                        float dy = wrapDelta(bj.y - bi.y, worldH);
+                        float rr = bi.r + bj.r;
+                        if (dx * dx + dy * dy < rr * rr) out.push_back({ static_cast<uint32_t>(i), j });
+                    }
+                }
+            }
+        }
+    };
+    pool_.run(chunks, scan);
+
+    contacts_.clear();
+    for (size_t c = 0; c < chunks; ++c) contacts_.insert(contacts_.end(), chunkContacts_[c].begin(), chunkContacts_[c].end());
+    stats_.contacts = static_cast<int>(contacts_.size());
+}
+
+void AsteroidPhysics::buildIslands() {
+    const size_t n = bodies_.size();
+    parent_.resize(n);
+    for (size_t i = 0; i < n; ++i) parent_[i] = static_cast<uint32_t>(i);
+    auto find = [&](uint32_t x) {
+        while (parent_[x] != x) {
+            parent_[x] = parent_[parent_[x]];
+            x = parent_[x];
+        }
+        return x;
+    };
+    // union towards the smaller index so roots don't depend on contact order
+    for (const Contact& c : contacts_) {
+        uint32_t ra = find(c.a), rb = find(c.b);
+        if (ra < rb) parent_[rb] = ra;
+        else if (rb < ra) parent_[ra] = rb;
+    }
+
+    // number islands by first appearance in the (sorted) contact list and
+    // bucket contacts per island, keeping their relative order
+    islandOfRoot_.assign(n, kNone);
+    islandStart_.assign(1, 0);
+    contactIsland_.resize(contacts_.size());
+    for (size_t c = 0; c < contacts_.size(); ++c) {
+        uint32_t root = find(contacts_[c].a);
+        if (islandOfRoot_[root] == kNone) {
+            islandOfRoot_[root] = static_cast<uint32_t>(islandStart_.size() - 1);
+            islandStart_.push_back(0);
+        }
+        contactIsland_[c] = islandOfRoot_[root];
+        ++islandStart_[contactIsland_[c] + 1];
+    }
+    for (size_t k = 1; k < islandStart_.size(); ++k) islandStart_[k] += islandStart_[k - 1];
+    islandContacts_.resize(contacts_.size());
+    cursor_.assign(islandStart_.begin(), islandStart_.end() - 1);
+    for (size_t c = 0; c < contacts_.size(); ++c) islandContacts_[cursor_[contactIsland_[c]]++] = contacts_[c];
+    stats_.islands = static_cast<int>(islandStart_.size() - 1);
+}
+
+void AsteroidPhysics::solveIsland(size_t island, float worldW, float worldH) {
+    const Contact* begin = islandContacts_.data() + islandStart_[island];
+    const Contact* end = islandContacts_.data() + islandStart_[island + 1];
+
+    auto normalOf = [&](const Body& a, const Body& b, float& nx, float& ny) {
+        float dx = wrapDelta(b.x - a.x, worldW);
+        float dy = wrapDelta(b.y - a.y, worldH);
+        float d = std::sqrt(dx * dx + dy * dy);
+        if (d > 1e-6f) { nx = dx / d; ny = dy / d; }
+        else { nx = 1.0f; ny = 0.0f; } // coincident centres: pick a fixed axis
+        return d;
+    };
+
+    for (int it = 0; it < kVelocityIterations; ++it) {
+        for (const Contact* c = begin; c != end; ++c) {
+            Body& a = bodies_[c->a];
+            Body& b = bodies_[c->b];
+            float im = a.invMass + b.invMass;
+            if (im <= 0.0f) continue;
+            float nx, ny;
+            normalOf(a, b, nx, ny);
+            float vn = (b.vx - a.vx) * nx + (b.vy - a.vy) * ny;
+            if (vn >= 0.0f) continue; // already separating
+            float j = -(1.0f + kRestitution) * vn / im;
+            a.vx -= j * a.invMass * nx;
+            a.vy -= j * a.invMass * ny;
+            b.vx += j * b.invMass * nx;
+            b.vy += j * b.invMass * ny;
+        }
+    }
+
+    for (const Contact* c = begin; c != end; ++c) {
+        Body& a = bodies_[c->a];
+        Body& b = bodies_[c->b];
+        float im = a.invMass + b.invMass;
+        if (im <= 0.0f) continue;
+        float nx, ny;
+        float d = normalOf(a, b, nx, ny);
+        float overlap = a.r + b.r - d - kSlop;
+        if (overlap <= 0.0f) continue;
+        float corr = overlap * kPushOut / im;
+        a.x -= nx * corr * a.invMass;
+        a.y -= ny * corr * a.invMass;
+        b.x += nx * corr * b.invMass;
+        b.y += ny * corr * b.invMass;
+    }
+}
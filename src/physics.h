@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "world.h"
+#include "worker_pool.h"
+
+// Asteroid motion and asteroid-asteroid collision response.
+//
+// Asteroids are treated as circles of their collision `radius` with mass
+// proportional to radius^2 (uniform density discs). Each step:
+//   1. integrate and wrap positions (same bounds as wrap() in the game),
+//   2. find overlapping pairs with a toroidal uniform grid,
+//   3. group touching asteroids into islands (union-find),
+//   4. solve each island's contacts with sequential impulses plus a
+//      positional push-out, islands in parallel on the worker pool.
+// Islands share no bodies and each is solved in a fixed order by a single
+// thread, so the result is bit-identical for any thread count.
+struct PhysicsStats {
+    int contacts = 0;
+    int islands = 0; // islands with at least one contact
+    unsigned threads = 1;
+};
+
+class AsteroidPhysics {
+public:
+    // `threads` as for WorkerPool (0 = hardware concurrency).
+    explicit AsteroidPhysics(unsigned threads = 0);
+
+    void step(std::vector<Asteroid>& asts, float dt, float worldW, float worldH);
+    const PhysicsStats& stats() const { return stats_; }
+
+private:
+    struct Body {
+        float x, y;
+        float vx, vy;
+        float r;
+        float invMass;
+    };
+    struct Contact {
+        uint32_t a, b;
+    };
+
+    void findContacts(float worldW, float worldH);
+    void buildIslands();
+    void solveIsland(size_t island, float worldW, float worldH);
+
+    WorkerPool pool_;
+    PhysicsStats stats_;
+    std::vector<Body> bodies_;
+    // broadphase grid (CSR layout: cellStart_[c]..cellStart_[c+1] in cellItems_)
+    std::vector<uint32_t> cellOf_;
+    std::vector<uint32_t> cellStart_;
+    std::vector<uint32_t> cellItems_;
+    std::vector<std::vector<Contact>> chunkContacts_;
+    std::vector<Contact> contacts_;
+    // islands (CSR layout over contacts_ order)
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> islandOfRoot_;
+    std::vector<uint32_t> islandStart_;
+    std::vector<uint32_t> contactIsland_;
+    std::vector<Contact> islandContacts_;
+    std::vector<uint32_t> cursor_; // scatter positions for the CSR fills
+};
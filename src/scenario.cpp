@@ -0,0 +1,323 @@
+#include "scenario.h"
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "alloc_stats.h"
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+
+// frame-time histogram: 0.05ms buckets up to 200ms, overflow goes in the last
+const double kBucketMs = 0.05;
+const size_t kBuckets = 4000;
+
+double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t bucketOf(double ms) {
+    size_t b = static_cast<size_t>(ms / kBucketMs);
+    return std::min(b, kBuckets - 1);
+}
+
+double percentile(const std::vector<uint32_t>& hist, double p, double maxMs) {
+    uint64_t total = 0;
+    for (uint32_t c : hist) total += c;
+    if (total == 0) return 0.0;
+    uint64_t want = static_cast<uint64_t>(std::ceil(p * total));
+    if (want == 0) want = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < hist.size(); ++i) {
+        seen += hist[i];
+        if (seen >= want) return i + 1 == hist.size() ? maxMs : (i + 0.5) * kBucketMs;
+    }
+    return maxMs;
+}
+
+// least-squares slope of y over x
+double slope(const std::vector<double>& x, const std::vector<double>& y) {
+    size_t n = x.size();
+    if (n < 2) return 0.0;
+    double mx = 0.0, my = 0.0;
+    for (size_t i = 0; i < n; ++i) { mx += x[i]; my += y[i]; }
+    mx /= n; my /= n;
+    double num = 0.0, den = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        num += (x[i] - mx) * (y[i] - my);
+        den += (x[i] - mx) * (x[i] - mx);
+    }
+    return den > 0.0 ? num / den : 0.0;
+}
+
+} // namespace
+
+const std::vector<ScenarioDef>& builtinScenarios() {
+    static const std::vector<ScenarioDef> defs = {
+        { "empty", ScenarioKind::Empty },
+        { "asteroids-1k", ScenarioKind::Asteroids1k },
+        { "asteroids-10k", ScenarioKind::Asteroids10k },
+        { "particle-storm", ScenarioKind::ParticleStorm },
+        { "menu-ttf", ScenarioKind::MenuTtf },
+        { "splitting", ScenarioKind::Splitting },
+    };
+    return defs;
+}
+
+void scenarioInput(uint64_t tick, bool& left, bool& right, bool& thrust) {
+    // 4 second cycle: thrust bursts, a held turn each way and some short taps
+    uint64_t t = tick % 240;
+    thrust = (t < 50) || (t >= 120 && t < 150);
+    left = (t >= 60 && t < 90) || (t % 37 == 0);
+    right = (t >= 180 && t < 200) || (t % 53 == 0);
+}
+
+uint64_t currentRssKb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.WorkingSetSize / 1024;
+    return 0;
+#elif defined(__linux__)
+    // stdio rather than ifstream: sampled during runs, so it must not show
+    // up in the operator new counts being measured
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    unsigned long long pages = 0, resident = 0;
+    const bool ok = fscanf(statm, "%llu %llu", &pages, &resident) == 2;
+    fclose(statm);
+    if (!ok) return 0;
+    return resident * static_cast<unsigned long long>(sysconf(_SC_PAGESIZE)) / 1024;
+#else
+    return peakRssKb(); // no cheap portable query; the peak is an upper bound
+#endif
+}
+
+uint64_t peakRssKb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize / 1024;
+    return 0;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#  if defined(__APPLE__)
+    return static_cast<uint64_t>(ru.ru_maxrss) / 1024; // bytes on macOS
+#  else
+    return static_cast<uint64_t>(ru.ru_maxrss); // KB on Linux/BSD
+#  endif
+#endif
+}
+
+bool ScenarioRunner::configure(const std::string& names, int ticks, double soakMinutes, const std::string& outPath) {
+    defs_.clear();
+    index_ = 0;
+    const std::vector<ScenarioDef>& all = builtinScenarios();
+    if (names == "all") {
+        defs_ = all;
+    } else {
+        std::stringstream ss(names);
+        std::string name;
+        while (std::getline(ss, name, ',')) {
+            auto it = std::find_if(all.begin(), all.end(), [&](const ScenarioDef& d) { return name == d.name; });
+            if (it == all.end()) {
+                SDL_Log("scenario: unknown scenario '%s'", name.c_str());
+                return false;
+            }
+            defs_.push_back(*it);
+        }
+    }
+    ticks_ = ticks > 0 ? ticks : 600;
+    soakSeconds_ = soakMinutes > 0.0 ? soakMinutes * 60.0 : 0.0;
+    outPath_ = outPath.empty() ? "scenario_results.csv" : outPath;
+    return !defs_.empty();
+}
+
+void ScenarioRunner::start() {
+    tick_ = 0;
+    drawCalls_ = 0;
+    frameMs_.assign(kBuckets, 0);
+    windowMs_.assign(kBuckets, 0);
+    samples_.clear();
+    samples_.reserve(1024);
+    sumMs_ = 0.0;
+    maxMs_ = 0.0;
+    windowMaxMs_ = 0.0;
+    startAllocs_ = allocationCount();
+    startBytes_ = allocatedBytes();
+    startSeconds_ = nowSeconds();
+    peakRssKb_ = currentRssKb();
+    SDL_Log("scenario: %s (%s)", current().name,
+        soakSeconds_ > 0.0 ? "soak" : (std::to_string(ticks_) + " ticks").c_str());
+}
+
+bool ScenarioRunner::recordFrame(double frameMs, uint64_t drawCalls, size_t asteroids, size_t sparks, size_t shootingStars) {
+    ++tick_;
+    drawCalls_ += drawCalls;
+    ++frameMs_[bucketOf(frameMs)];
+    sumMs_ += frameMs;
+    maxMs_ = std::max(maxMs_, frameMs);
+    if (tick_ % kRssSampleTicks == 0) peakRssKb_ = std::max(peakRssKb_, currentRssKb());
+    bool done = false;
+    if (soakSeconds_ > 0.0) {
+        ++windowMs_[bucketOf(frameMs)];
+        windowMaxMs_ = std::max(windowMaxMs_, frameMs);
+        if (tick_ % kSoakWindowTicks == 0) {
+            SoakSample s;
+            s.seconds = nowSeconds() - startSeconds_;
+            s.rssKb = currentRssKb();
+            peakRssKb_ = std::max(peakRssKb_, s.rssKb);
+            s.p50Ms = percentile(windowMs_, 0.50, windowMaxMs_);
+            s.p99Ms = percentile(windowMs_, 0.99, windowMaxMs_);
+            s.asteroids = asteroids;
+            s.sparks = sparks;
+            s.shootingStars = shootingStars;
+            s.allocations = allocationCount() - startAllocs_;
+            samples_.push_back(s);
+            std::fill(windowMs_.begin(), windowMs_.end(), 0);
+            windowMaxMs_ = 0.0;
+            done = s.seconds >= soakSeconds_;
+        }
+    } else {
+        done = tick_ >= static_cast<uint64_t>(ticks_);
+    }
+    if (done) finish(asteroids, sparks, shootingStars);
+    return done;
+}
+
+void ScenarioRunner::finish(size_t asteroids, size_t sparks, size_t shootingStars) {
+    ScenarioResult r;
+    r.name = current().name;
+    r.ticks = static_cast<int>(tick_);
+    r.meanMs = tick_ ? sumMs_ / tick_ : 0.0;
+    r.p50Ms = percentile(frameMs_, 0.50, maxMs_);
+    r.p90Ms = percentile(frameMs_, 0.90, maxMs_);
+    r.p99Ms = percentile(frameMs_, 0.99, maxMs_);
+    r.maxMs = maxMs_;
+    r.peakRssKb = std::max(peakRssKb_, currentRssKb());
+    r.allocations = allocationCount() - startAllocs_;
+    r.allocBytes = allocatedBytes() - startBytes_;
+    r.drawCallsPerFrame = tick_ ? static_cast<double>(drawCalls_) / tick_ : 0.0;
+    r.asteroids = asteroids;
+    r.sparks = sparks;
+    r.shootingStars = shootingStars;
+
+    if (soakSeconds_ > 0.0) {
+        r.soak = true;
+        r.hours = (nowSeconds() - startSeconds_) / 3600.0;
+        // skip the first window: caches, pools and the rewind ring fill up there
+        std::vector<double> hrs, rss, p50, spk;
+        for (size_t i = samples_.size() > 2 ? 1 : 0; i < samples_.size(); ++i) {
+            hrs.push_back(samples_[i].seconds / 3600.0);
+            rss.push_back(static_cast<double>(samples_[i].rssKb));
+            p50.push_back(samples_[i].p50Ms);
+            spk.push_back(static_cast<double>(samples_[i].sparks));
+        }
+        r.rssSlopeKbPerHour = slope(hrs, rss);
+        r.frameSlopeMsPerHour = slope(hrs, p50);
+        r.sparksSlopePerHour = slope(hrs, spk);
+        double span = hrs.size() > 1 ? hrs.back() - hrs.front() : 0.0;
+        double baseMs = p50.empty() ? 0.0 : std::max(p50.front(), kBucketMs);
+        // flag >1MB/hour of steady growth (or a spark list that keeps getting
+        // longer, which RSS only shows much later), or a >10% shift of the
+        // median frame
+        r.memoryGrowth = (r.rssSlopeKbPerHour > 1024.0 && r.rssSlopeKbPerHour * span > 1024.0)
+            || r.sparksSlopePerHour * span > 1000.0;
+        r.frameDrift = std::fabs(r.frameSlopeMsPerHour * span) > 0.1 * baseMs;
+        SDL_Log("scenario: soak %s over %.2f h: rss %+.0f KB/h%s, p50 frame %+.3f ms/h%s, sparks %+.1f/h",
+            r.name.c_str(), r.hours, r.rssSlopeKbPerHour, r.memoryGrowth ? " (GROWTH)" : "",
+            r.frameSlopeMsPerHour, r.frameDrift ? " (DRIFT)" : "", r.sparksSlopePerHour);
+        soakLogs_.push_back(samples_);
+    }
+    SDL_Log("scenario: %s: %d ticks, mean %.3f ms, p50 %.3f, p90 %.3f, p99 %.3f, max %.3f, peak rss %llu KB, %llu allocs, %.1f draw calls/frame",
+        r.name.c_str(), r.ticks, r.meanMs, r.p50Ms, r.p90Ms, r.p99Ms, r.maxMs,
+        (unsigned long long)r.peakRssKb, (unsigned long long)r.allocations, r.drawCallsPerFrame);
+    results_.push_back(r);
+}
+
+bool ScenarioRunner::next() {
+    ++index_;
+    return active();
+}
+
+bool ScenarioRunner::writeResults() const {
+    const bool json = outPath_.size() >= 5 && outPath_.compare(outPath_.size() - 5, 5, ".json") == 0;
+    std::ofstream ofs(outPath_, std::ios::trunc);
+    if (!ofs) {
+        SDL_Log("scenario: cannot write %s", outPath_.c_str());
+        return false;
+    }
+    char buf[512];
+    if (json) {
+        ofs << "[\n";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const ScenarioResult& r = results_[i];
+            snprintf(buf, sizeof(buf),
+                "  {\"scenario\": \"%s\", \"ticks\": %d, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p90_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f, "
+                "\"peak_rss_kb\": %llu, \"allocations\": %llu, \"alloc_bytes\": %llu, \"draw_calls_per_frame\": %.2f, "
+                "\"asteroids\": %zu, \"sparks\": %zu, \"shooting_stars\": %zu",
+                r.name.c_str(), r.ticks, r.meanMs, r.p50Ms, r.p90Ms, r.p99Ms, r.maxMs,
+                (unsigned long long)r.peakRssKb, (unsigned long long)r.allocations, (unsigned long long)r.allocBytes,
+                r.drawCallsPerFrame, r.asteroids, r.sparks, r.shootingStars);
+            ofs << buf;
+            if (r.soak) {
+                snprintf(buf, sizeof(buf),
+                    ", \"soak_hours\": %.4f, \"rss_slope_kb_per_hour\": %.1f, \"p50_slope_ms_per_hour\": %.4f, "
+                    "\"sparks_slope_per_hour\": %.2f, \"memory_growth\": %s, \"frame_drift\": %s",
+                    r.hours, r.rssSlopeKbPerHour, r.frameSlopeMsPerHour, r.sparksSlopePerHour,
+                    r.memoryGrowth ? "true" : "false", r.frameDrift ? "true" : "false");
+                ofs << buf;
+            }
+            ofs << (i + 1 < results_.size() ? "},\n" : "}\n");
+        }
+        ofs << "]\n";
+    } else {
+        ofs << "scenario,ticks,mean_ms,p50_ms,p90_ms,p99_ms,max_ms,peak_rss_kb,allocations,alloc_bytes,draw_calls_per_frame,"
+               "asteroids,sparks,shooting_stars,soak_hours,rss_slope_kb_per_hour,p50_slope_ms_per_hour,sparks_slope_per_hour,memory_growth,frame_drift\n";
+        for (const ScenarioResult& r : results_) {
+            snprintf(buf, sizeof(buf), "%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%llu,%llu,%llu,%.2f,%zu,%zu,%zu,%.4f,%.1f,%.4f,%.2f,%d,%d\n",
+                r.name.c_str(), r.ticks, r.meanMs, r.p50Ms, r.p90Ms, r.p99Ms, r.maxMs,
+                (unsigned long long)r.peakRssKb, (unsigned long long)r.allocations, (unsigned long long)r.allocBytes,
+                r.drawCallsPerFrame, r.asteroids, r.sparks, r.shootingStars,
+                r.hours, r.rssSlopeKbPerHour, r.frameSlopeMsPerHour, r.sparksSlopePerHour,
+                r.memoryGrowth ? 1 : 0, r.frameDrift ? 1 : 0);
+            ofs << buf;
+        }
+    }
+    SDL_Log("scenario: results written to %s", outPath_.c_str());
+
+    if (!soakLogs_.empty()) {
+        // per-window samples next to the report, for plotting
+        std::string soakPath = outPath_ + ".soak.csv";
+        std::ofstream soak(soakPath, std::ios::trunc);
+        if (!soak) return false;
+        soak << "scenario,seconds,rss_kb,p50_ms,p99_ms,asteroids,sparks,shooting_stars,allocations\n";
+        size_t li = 0;
+        for (const ScenarioResult& r : results_) {
+            if (!r.soak) continue;
+            for (const SoakSample& s : soakLogs_[li]) {
+                snprintf(buf, sizeof(buf), "%s,%.1f,%llu,%.4f,%.4f,%zu,%zu,%zu,%llu\n",
+                    r.name.c_str(), s.seconds, (unsigned long long)s.rssKb, s.p50Ms, s.p99Ms,
+                    s.asteroids, s.sparks, s.shootingStars, (unsigned long long)s.allocations);
+                soak << buf;
+            }
+            ++li;
+        }
+        SDL_Log("scenario: soak samples written to %s", soakPath.c_str());
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// End-to-end benchmark scenes for `--scenario`. Each runs the real game loop
+// for a fixed number of ticks at a fixed 1/60s step with scripted input and
+// a fixed RNG seed, so two runs of the same build do the same work.
+enum class ScenarioKind {
+    Empty,         // ship only
+    Asteroids1k,   // 1,000 asteroids
+    Asteroids10k,  // 10,000 asteroids
+    ParticleStorm, // hundreds of sparks spawned every tick
+    MenuTtf,       // in-game menu open (TTF text when available)
+    Splitting      // ship is steered into an asteroid every tick
+};
+
+struct ScenarioDef {
+    const char* name;
+    ScenarioKind kind;
+};
+
+const std::vector<ScenarioDef>& builtinScenarios();
+
+// Scripted controls for `tick`: rotate/thrust patterns that sweep the ship
+// around the field.
+void scenarioInput(uint64_t tick, bool& left, bool& right, bool& thrust);
+
+// Current and whole-process peak resident set size in KB (0 where
+// unsupported).
+uint64_t currentRssKb();
+uint64_t peakRssKb();
+
+struct ScenarioResult {
+    std::string name;
+    int ticks = 0;
+    double meanMs = 0.0, p50Ms = 0.0, p90Ms = 0.0, p99Ms = 0.0, maxMs = 0.0;
+    uint64_t peakRssKb = 0; // highest RSS sampled during this scenario
+    uint64_t allocations = 0;
+    uint64_t allocBytes = 0;
+    double drawCallsPerFrame = 0.0;
+    size_t asteroids = 0, sparks = 0, shootingStars = 0; // at the end
+    // soak only: least-squares trends over the run
+    bool soak = false;
+    double hours = 0.0;
+    double rssSlopeKbPerHour = 0.0;
+    double frameSlopeMsPerHour = 0.0;
+    double sparksSlopePerHour = 0.0;
+    bool memoryGrowth = false;
+    bool frameDrift = false;
+};
+
+// One row of the soak log, taken every `kSoakWindowTicks` ticks.
+struct SoakSample {
+    double seconds;
+    uint64_t rssKb;
+    double p50Ms;
+    double p99Ms;
+    size_t asteroids, sparks, shootingStars;
+    uint64_t allocations;
+};
+
+// Drives the scenario list: which scene is active, per-frame measurements,
+// and the CSV/JSON report.
+class ScenarioRunner {
+public:
+    static const int kSoakWindowTicks = 600;
+    // RSS is sampled this often (and at start/finish) for the per-scenario
+    // peak; the OS peak covers the whole process, so it would carry one
+    // scene's high-water mark into every later row
+    static const int kRssSampleTicks = 60;
+
+    // `names` is a comma-separated list or "all". `soakMinutes` > 0 turns each
+    // scenario into a soak run of that wall-clock length (ticks ignored).
+    // Returns false on an unknown scenario name.
+    bool configure(const std::string& names, int ticks, double soakMinutes, const std::string& outPath);
+    bool active() const { return index_ < defs_.size(); }
+    const ScenarioDef& current() const { return defs_[index_]; }
+    uint64_t tick() const { return tick_; }
+
+    // Begin measuring the current scenario.
+    void start();
+    // Record one finished frame. Returns true when the scenario is complete.
+    bool recordFrame(double frameMs, uint64_t drawCalls, size_t asteroids, size_t sparks, size_t shootingStars);
+    // Close the current scenario and move on; false when none are left.
+    bool next();
+    // Write the report to the configured path (.json or CSV otherwise).
+    bool writeResults() const;
+
+private:
+    void finish(size_t asteroids, size_t sparks, size_t shootingStars);
+
+    std::vector<ScenarioDef> defs_;
+    size_t index_ = 0;
+    int ticks_ = 600;
+    double soakSeconds_ = 0.0;
+    std::string outPath_;
+    // current scenario
+    uint64_t tick_ = 0;
+    double startSeconds_ = 0.0;
+    uint64_t startAllocs_ = 0, startBytes_ = 0;
+    uint64_t drawCalls_ = 0;
+    uint64_t peakRssKb_ = 0;
+    // frame-time histograms: whole run and current soak window (fixed size,
+    // so an hours-long soak doesn't grow the process it is watching)
+    std::vector<uint32_t> frameMs_;
+    std::vector<uint32_t> windowMs_;
+    double sumMs_ = 0.0, maxMs_ = 0.0, windowMaxMs_ = 0.0;
+    std::vector<SoakSample> samples_;
+    // finished
+    std::vector<ScenarioResult> results_;
+    std::vector<std::vector<SoakSample>> soakLogs_;
+};
@@ -0,0 +1,382 @@
+#include "snapshot.h"
+#include <cstring>
+#include <cstdio>
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+
+const uint32_t kSnapshotMagic = 0x31574253; // "SBW1" on disk
+const uint16_t kSnapshotVersion = 1;
+
+struct ByteWriter {
+    std::vector<uint8_t>& out;
+    template <typename T> void put(const T& v) {
+        size_t at = out.size();
+        out.resize(at + sizeof(T));
+        std::memcpy(out.data() + at, &v, sizeof(T));
+    }
+    void putVec2(const Vec2& v) { put(v.x); put(v.y); }
+};
+
+struct ByteReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    template <typename T> bool get(T& v) {
+        if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+    bool getVec2(Vec2& v) { return get(v.x) && get(v.y); }
+    // guard element counts against the bytes actually left so a corrupt
+    // count can't trigger a huge allocation
+    bool fits(uint32_t n, size_t minElemSize) const {
+        return static_cast<size_t>(end - p) / minElemSize >= n;
+    }
+};
+
+// LEB128 varints for the delta run lengths
+void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) { out.push_back(static_cast<uint8_t>(v | 0x80)); v >>= 7; }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p >= end) return false;
+        uint8_t b = *p++;
+        v |= static_cast<uint32_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// Encode cur ^ prev as a sequence of (zeroRun, literalLen, literal xor bytes).
+// A trailing zero run is implied and not emitted.
+void encodeDelta(const std::vector<uint8_t>& prev, const std::vector<uint8_t>& cur, std::vector<uint8_t>& out) {
+    out.clear();
+    const size_t n = cur.size();
+    size_t i = 0;
+    while (i < n) {
+        size_t zs = i;
+        while (i < n && cur[i] == prev[i]) ++i;
+        if (i == n) break;
+        size_t ls = i;
+        // end the literal at the first run of 4+ unchanged bytes; shorter runs
+        // are cheaper to carry inline than to start another token
+        while (i < n) {
+            if (cur[i] != prev[i]) { ++i; continue; }
+            size_t j = i;
+            while (j < n && j - i < 4 && cur[j] == prev[j]) ++j;
+            if (j - i >= 4 || j == n) break;
+            i = j;
+        }
+        putVarint(out, static_cast<uint32_t>(ls - zs));
+        putVarint(out, static_cast<uint32_t>(i - ls));
+        for (size_t k = ls; k < i; ++k) out.push_back(cur[k] ^ prev[k]);
+    }
+}
+
+// Apply an encoded delta in place on top of `raw` (which holds the previous tick).
+bool applyDelta(const std::vector<uint8_t>& delta, std::vector<uint8_t>& raw) {
+    const uint8_t* p = delta.data();
+    const uint8_t* end = p + delta.size();
+    size_t at = 0;
+    while (p < end) {
+        uint32_t zeros = 0, lits = 0;
+        if (!getVarint(p, end, zeros) || !getVarint(p, end, lits)) return false;
+        at += zeros;
+        if (at + lits > raw.size() || static_cast<size_t>(end - p) < lits) return false;
+        for (uint32_t k = 0; k < lits; ++k) raw[at + k] ^= p[k];
+        p += lits;
+        at += lits;
+    }
+    return at <= raw.size();
+}
+
+#ifdef _WIN32
+struct MappedFile {
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    uint8_t* data = nullptr;
+    size_t size = 0;
+
+    bool create(const std::string& path, size_t n) {
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(n) >> 32), static_cast<DWORD>(n), NULL);
+        if (!mapping) return false;
+        data = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, n));
+        size = n;
+        return data != nullptr;
+    }
+    bool open(const std::string& path) {
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(file, &sz) || sz.QuadPart == 0) return false;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping) return false;
+        data = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        size = static_cast<size_t>(sz.QuadPart);
+        return data != nullptr;
+    }
+    ~MappedFile() {
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    }
+};
+#else
+struct MappedFile {
+    int fd = -1;
+    uint8_t* data = nullptr;
+    size_t size = 0;
+
+    bool create(const std::string& path, size_t n) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, static_cast<off_t>(n)) != 0) return false;
+        void* m = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (m == MAP_FAILED) return false;
+        data = static_cast<uint8_t*>(m);
+        size = n;
+        return true;
+    }
+    bool open(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) return false;
+        void* m = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED) return false;
+        data = static_cast<uint8_t*>(m);
+        size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+    ~MappedFile() {
+        if (data) munmap(data, size);
+        if (fd >= 0) ::close(fd);
+    }
+};
+#endif
+
+} // namespace
+
+void serializeWorld(const World& w, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t approx = 64 + w.sparks.size() * 20 + w.shootingStars.size() * 28;
+    for (const auto& a : w.asts) approx += 24 + a.shape.size() * 8;
+    out.reserve(approx);
+
+    ByteWriter bw{ out };
+    bw.put(kSnapshotMagic);
+    bw.put(kSnapshotVersion);
+    bw.put(static_cast<uint16_t>(0)); // reserved
+    bw.put(w.tick);
+    bw.putVec2(w.shipPos);
+    bw.put(w.shipAngle);
+    bw.putVec2(w.shipVel);
+    bw.put(w.collisionFlash);
+    bw.put(w.rng.state);
+    bw.put(w.rng.inc);
+
+    bw.put(static_cast<uint32_t>(w.asts.size()));
+    for (const auto& a : w.asts) {
+        bw.putVec2(a.pos);
+        bw.putVec2(a.vel);
+        bw.put(a.radius);
+        bw.put(static_cast<uint32_t>(a.shape.size()));
+        for (const auto& p : a.shape) bw.putVec2(p);
+    }
+    bw.put(static_cast<uint32_t>(w.sparks.size()));
+    for (const auto& s : w.sparks) {
+        bw.putVec2(s.pos);
+        bw.put(s.life);
+        bw.put(s.maxLife);
+        bw.put(s.size);
+    }
+    bw.put(static_cast<uint32_t>(w.shootingStars.size()));
+    for (const auto& ss : w.shootingStars) {
+        bw.putVec2(ss.pos);
+        bw.putVec2(ss.vel);
+        bw.put(ss.life);
+        bw.put(ss.maxLife);
+        bw.put(ss.length);
+    }
+}
+
+bool deserializeWorld(const uint8_t* data, size_t size, World& w) {
+    ByteReader br{ data, data + size };
+    uint32_t magic = 0;
+    uint16_t version = 0, reserved = 0;
+    if (!br.get(magic) || magic != kSnapshotMagic) return false;
+    if (!br.get(version) || version != kSnapshotVersion) return false;
+    if (!br.get(reserved)) return false;
+
+    // decode into a temporary so a malformed tail leaves `w` intact
+    World t;
+    if (!br.get(t.tick)) return false;
+    if (!br.getVec2(t.shipPos) || !br.get(t.shipAngle) || !br.getVec2(t.shipVel)) return false;
+    if (!br.get(t.collisionFlash)) return false;
+    if (!br.get(t.rng.state) || !br.get(t.rng.inc)) return false;
+
+    uint32_t n = 0;
+    if (!br.get(n) || !br.fits(n, 24)) return false;
+    t.asts.resize(n);
+    for (auto& a : t.asts) {
+        uint32_t verts = 0;
+        if (!br.getVec2(a.pos) || !br.getVec2(a.vel) || !br.get(a.radius)) return false;
+        if (!br.get(verts) || !br.fits(verts, 8)) return false;
+        a.shape.resize(verts);
+        for (auto& p : a.shape) if (!br.getVec2(p)) return false;
+    }
+    if (!br.get(n) || !br.fits(n, 20)) return false;
+    t.sparks.resize(n);
+    for (auto& s : t.sparks) {
+        if (!br.getVec2(s.pos) || !br.get(s.life) || !br.get(s.maxLife) || !br.get(s.size)) return false;
+    }
+    if (!br.get(n) || !br.fits(n, 28)) return false;
+    t.shootingStars.resize(n);
+    for (auto& ss : t.shootingStars) {
+        if (!br.getVec2(ss.pos) || !br.getVec2(ss.vel)) return false;
+        if (!br.get(ss.life) || !br.get(ss.maxLife) || !br.get(ss.length)) return false;
+    }
+    w = std::move(t);
+    return true;
+}
+
+bool saveSnapshotFile(const std::string& path, const World& w) {
+    std::vector<uint8_t> raw;
+    serializeWorld(w, raw);
+    {
+        // write to a sibling file first so a failed save never clobbers the last good one
+        MappedFile mf;
+        if (!mf.create(path + ".tmp", raw.size())) return false;
+        std::memcpy(mf.data, raw.data(), raw.size());
+    }
+#ifdef _WIN32
+    return MoveFileExA((path + ".tmp").c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename((path + ".tmp").c_str(), path.c_str()) == 0;
+#endif
+}
+
+bool loadSnapshotFile(const std::string& path, World& w) {
+    MappedFile mf;
+    if (!mf.open(path)) return false;
+    return deserializeWorld(mf.data, mf.size, w);
+}
+
+SnapshotRing::SnapshotRing(size_t maxTicks, size_t byteBudget, int keyframeInterval)
+    : slots_(maxTicks > 1 ? maxTicks : 2), byteBudget_(byteBudget),
+      keyframeInterval_(keyframeInterval > 0 ? keyframeInterval : 1) {}
+
+void SnapshotRing::clear() {
+    tail_ = 0;
+    count_ = 0;
+    bytesUsed_ = 0;
+    sinceKeyframe_ = 0;
+    prevRaw_.clear();
+    for (auto& e : slots_) std::vector<uint8_t>().swap(e.data);
+}
+
+uint64_t SnapshotRing::oldestTick() const {
+    return count_ ? slots_[tail_].tick : 0;
+}
+
+uint64_t SnapshotRing::newestTick() const {
+    return count_ ? slots_[slotIndex(count_ - 1)].tick : 0;
+}
+
+void SnapshotRing::dropOldest() {
+    // drop the oldest keyframe and every delta that depends on it
+    do {
+        Entry& e = slots_[tail_];
+        bytesUsed_ -= e.data.capacity();
+        std::vector<uint8_t>().swap(e.data);
+        tail_ = (tail_ + 1) % slots_.size();
+        --count_;
+    } while (count_ > 0 && !slots_[tail_].keyframe);
+}
+
+void SnapshotRing::push(const World& w) {
+    if (count_ > 0 && w.tick != newestTick() + 1) clear();
+
+    serializeWorld(w, curRaw_);
+    bool key = count_ == 0 || sinceKeyframe_ + 1 >= keyframeInterval_ || curRaw_.size() != prevRaw_.size();
+    if (!key) {
+        encodeDelta(prevRaw_, curRaw_, scratch_);
+        // a delta that isn't smaller than the frame is pointless
+        if (scratch_.size() >= curRaw_.size()) key = true;
+    }
+    const std::vector<uint8_t>& payload = key ? curRaw_ : scratch_;
+
+    while (count_ > 0 && (count_ == slots_.size() || bytesUsed_ + payload.size() > byteBudget_)) dropOldest();
+    if (count_ == 0 && !key) {
+        key = true; // the base this delta referred to was evicted
+    }
+    const std::vector<uint8_t>& stored = key ? curRaw_ : scratch_;
+
+    Entry& e = slots_[slotIndex(count_)];
+    bytesUsed_ -= e.data.capacity(); // normally 0: evicted/cleared slots are released
+    e.tick = w.tick;
+    e.keyframe = key;
+    e.rawSize = static_cast<uint32_t>(curRaw_.size());
+    e.data.assign(stored.begin(), stored.end());
+    bytesUsed_ += e.data.capacity();
+    ++count_;
+    sinceKeyframe_ = key ? 0 : sinceKeyframe_ + 1;
+    prevRaw_.swap(curRaw_);
+}
+
+bool SnapshotRing::decode(size_t i, std::vector<uint8_t>& raw) const {
+    size_t k = i;
+    while (!slots_[slotIndex(k)].keyframe) {
+        if (k == 0) return false;
+        --k;
+    }
+    const Entry& key = slots_[slotIndex(k)];
+    raw.assign(key.data.begin(), key.data.end());
+    for (size_t j = k + 1; j <= i; ++j) {
+        const Entry& e = slots_[slotIndex(j)];
+        if (e.rawSize != raw.size() || !applyDelta(e.data, raw)) return false;
+    }
+    return true;
+}
+
+bool SnapshotRing::restore(uint64_t tick, World& out) const {
+    if (count_ == 0 || tick < oldestTick() || tick > newestTick()) return false;
+    if (!decode(static_cast<size_t>(tick - oldestTick()), scratch_)) return false;
+    return deserializeWorld(scratch_.data(), scratch_.size(), out);
+}
+
+bool SnapshotRing::popLatest(World& out) {
+    // the newest entry is the state currently on screen; step back to the
+    // one before it, and only drop the newest once that has been restored
+    if (count_ < 2) return false;
+    if (!restore(newestTick() - 1, out)) return false;
+
+    Entry& newest = slots_[slotIndex(count_ - 1)];
+    bytesUsed_ -= newest.data.capacity();
+    std::vector<uint8_t>().swap(newest.data);
+    --count_;
+    prevRaw_.swap(scratch_); // restore() left the new newest entry's bytes there
+    sinceKeyframe_ = 0;
+    for (size_t j = count_ - 1; j > 0 && !slots_[slotIndex(j)].keyframe; --j) ++sinceKeyframe_;
+    return true;
+}
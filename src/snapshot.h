@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "world.h"
+
+// Binary world snapshots.
+//
+// A snapshot is a flat little header followed by the raw fields of `World`
+// (native endianness, floats stored bit-exact). The same bytes are used for
+// the in-memory rewind ring and for save files on disk.
+
+// Serialize `w` into `out` (cleared first). Never fails.
+void serializeWorld(const World& w, std::vector<uint8_t>& out);
+// Rebuild `w` from `data`. Returns false (leaving `w` untouched) if the bytes
+// are truncated, carry the wrong magic/version, or are otherwise malformed.
+bool deserializeWorld(const uint8_t* data, size_t size, World& w);
+
+// Save/resume through a memory-mapped file so large worlds are written and
+// read without intermediate stream buffering.
+bool saveSnapshotFile(const std::string& path, const World& w);
+bool loadSnapshotFile(const std::string& path, World& w);
+
+// Fixed-capacity ring of per-tick snapshots for rewind and replay seeking.
+//
+// Every `keyframeInterval` ticks (or whenever the serialized size changes,
+// e.g. an asteroid split) a full snapshot is stored; other ticks store the
+// XOR against the previous tick, run-length encoded over zero bytes. Static
+// data such as asteroid shapes therefore costs almost nothing per tick.
+// The oldest entries are dropped when either the slot count or the byte
+// budget is exceeded; deltas whose keyframe was dropped go with it, so every
+// tick between oldestTick() and newestTick() is always restorable.
+class SnapshotRing {
+public:
+    // Defaults hold 34s at 60Hz for the stock field in well under 1MB; the
+    // byte budget caps dense fields to a few MB at the cost of history.
+    explicit SnapshotRing(size_t maxTicks = 2048, size_t byteBudget = 4u << 20, int keyframeInterval = 60);
+
+    // Record `w` as the state for tick `w.tick`. Ticks must be consecutive;
+    // a gap (or going backwards) clears the ring and starts a new keyframe.
+    void push(const World& w);
+    // Restore the state recorded for `tick` (replay seeking). False if it's
+    // outside the ring or fails to decode; `out` is then left untouched.
+    bool restore(uint64_t tick, World& out) const;
+    // One step of rewind: restore the entry before the newest into `out`,
+    // then drop the newest. On failure neither `out` nor the ring changes.
+    bool popLatest(World& out);
+    void clear();
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+    uint64_t oldestTick() const;
+    uint64_t newestTick() const;
+    size_t bytesUsed() const { return bytesUsed_; }
+
+private:
+    struct Entry {
+        uint64_t tick = 0;
+        bool keyframe = false;
+        uint32_t rawSize = 0; // decoded size, used to size the scratch buffer
+        std::vector<uint8_t> data;
+    };
+    size_t slotIndex(size_t i) const { return (tail_ + i) % slots_.size(); }
+    void dropOldest();
+    bool decode(size_t i, std::vector<uint8_t>& raw) const;
+
+    std::vector<Entry> slots_;
+    size_t tail_ = 0; // oldest entry
+    size_t count_ = 0;
+    size_t bytesUsed_ = 0;
+    size_t byteBudget_;
+    int keyframeInterval_;
+    int sinceKeyframe_ = 0;
+    std::vector<uint8_t> prevRaw_; // raw bytes of the newest entry
+    std::vector<uint8_t> curRaw_;
+    mutable std::vector<uint8_t> scratch_; // encode/decode buffer, also used by restore()
+};
@@ -0,0 +1,513 @@
+#include "softraster.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define SOFTRASTER_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+namespace {
+
+const int kSub = 16;             // 28.4 fixed point: 16 sample steps per pixel
+const float kMaxCoord = 8192.0f; // keeps every edge value inside a tile in int32
+
+// Sample offsets from the pixel centre in 1/16 px: a 4-sample rotated grid,
+// or the centre alone when anti-aliasing is off.
+const int kAaOffsets[4][2] = { { -6, -2 }, { 2, -6 }, { 6, 2 }, { -2, 6 } };
+const int kCentreOffset[1][2] = { { 0, 0 } };
+
+uint32_t premultiply(SDL_Color c) {
+    const uint32_t a = c.a;
+    const uint32_t r = (c.r * a + 127) / 255;
+    const uint32_t g = (c.g * a + 127) / 255;
+    const uint32_t b = (c.b * a + 127) / 255;
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// An edge that crosses a tile or block; `e` is its value at the centre of
+// the region's first 4-pixel group and first row.
+struct LocalEdge {
+    int32_t a, b, e;
+};
+
+// The pieces of one shape that reach a tile or block, with only their
+// crossing edges; piece p owns edges [end[p - 1], end[p]).
+struct LocalPieces {
+    LocalEdge edges[SoftRaster::kMaxEdges];
+    int end[SoftRaster::kMaxPieces];
+    int pieces = 0, count = 0;
+};
+
+// Turn direction at b along a -> b -> c (> 0 clockwise on screen).
+int64_t turn(int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t cx, int32_t cy) {
+    return static_cast<int64_t>(bx - ax) * (cy - by) - static_cast<int64_t>(by - ay) * (cx - bx);
+}
+
+// Premultiplied "over" with coverage k in 0..256:
+// dst = src * k + dst * (1 - srcAlpha * k)
+inline void blend1(uint32_t* dst, uint32_t k, uint32_t color, uint32_t alpha) {
+    const uint32_t inv = 256 - ((alpha * k) >> 8);
+    const uint32_t d = *dst;
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t v = ((((color >> shift) & 0xFF) * k) >> 8) + ((((d >> shift) & 0xFF) * inv) >> 8);
+        out |= std::min<uint32_t>(v, 255) << shift;
+    }
+    *dst = out;
+}
+
+#ifdef SOFTRASTER_SSE2
+// blend1 for four pixels with per-pixel coverage. Every product is at most
+// 255 * 256, so 16-bit multiplies are exact.
+inline void blend4(uint32_t* dst, __m128i k, __m128i src16, __m128i alpha32) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i sa = _mm_srli_epi32(_mm_mullo_epi16(k, alpha32), 8);
+    const __m128i inv = _mm_sub_epi32(_mm_set1_epi32(256), sa);
+    // spread each pixel's factor over its four channels
+    const __m128i k2 = _mm_or_si128(k, _mm_slli_epi32(k, 16));
+    const __m128i inv2 = _mm_or_si128(inv, _mm_slli_epi32(inv, 16));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+    const __m128i dlo = _mm_unpacklo_epi8(d, zero);
+    const __m128i dhi = _mm_unpackhi_epi8(d, zero);
+    const __m128i lo = _mm_add_epi16(
+        _mm_srli_epi16(_mm_mullo_epi16(src16, _mm_unpacklo_epi32(k2, k2)), 8),
+        _mm_srli_epi16(_mm_mullo_epi16(dlo, _mm_unpacklo_epi32(inv2, inv2)), 8));
+    const __m128i hi = _mm_add_epi16(
+        _mm_srli_epi16(_mm_mullo_epi16(src16, _mm_unpackhi_epi32(k2, k2)), 8),
+        _mm_srli_epi16(_mm_mullo_epi16(dhi, _mm_unpackhi_epi32(inv2, inv2)), 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(lo, hi));
+}
+#endif
+
+// Pixel rectangle covering the flagged tiles of `a` (and `b`, if given).
+SDL_Rect dirtyBounds(const std::vector<uint8_t>& a, const std::vector<uint8_t>* b, int tilesX, int tile, int w, int h) {
+    int minX = tilesX, minY = static_cast<int>(a.size()), maxX = -1, maxY = -1;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!a[i] && !(b && (*b)[i])) continue;
+        int tx = static_cast<int>(i) % tilesX, ty = static_cast<int>(i) / tilesX;
+        minX = std::min(minX, tx);
+        maxX = std::max(maxX, tx);
+        minY = std::min(minY, ty);
+        maxY = std::max(maxY, ty);
+    }
+    if (maxX < 0) return SDL_Rect{ 0, 0, 0, 0 };
+    SDL_Rect r;
+    r.x = minX * tile;
+    r.y = minY * tile;
+    r.w = std::min((maxX + 1) * tile, w) - r.x;
+    r.h = std::min((maxY + 1) * tile, h) - r.y;
+    return r;
+}
+
+// Colour and sampling of the shape being drawn, plus where it goes.
+struct Target {
+    uint32_t* pixels;
+    int stride;
+    uint32_t color; // premultiplied
+    uint32_t alpha;
+    bool antialias;
+};
+
+// Solid fill of [x0,x1) x [y0,y1), for blocks entirely inside a shape.
+void fillRect(const Target& tg, int x0, int x1, int y0, int y1) {
+#ifdef SOFTRASTER_SSE2
+    const __m128i src16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(tg.color)), _mm_setzero_si128());
+    const __m128i alpha32 = _mm_set1_epi32(static_cast<int>(tg.alpha));
+    const __m128i lane = _mm_set_epi32(3, 2, 1, 0);
+    const __m128i first = _mm_set1_epi32(x0 - 1), end = _mm_set1_epi32(x1);
+    for (int y = y0; y < y1; ++y) {
+        uint32_t* row = tg.pixels + static_cast<size_t>(y) * tg.stride;
+        for (int x = x0 & ~3; x < x1; x += 4) {
+            // groups are 4-aligned; mask off the pixels outside [x0, x1)
+            const __m128i xs = _mm_add_epi32(_mm_set1_epi32(x), lane);
+            const __m128i in = _mm_and_si128(_mm_cmpgt_epi32(xs, first), _mm_cmplt_epi32(xs, end));
+            blend4(row + x, _mm_and_si128(in, _mm_set1_epi32(256)), src16, alpha32);
+        }
+    }
+#else
+    for (int y = y0; y < y1; ++y) {
+        uint32_t* row = tg.pixels + static_cast<size_t>(y) * tg.stride;
+        for (int x = x0; x < x1; ++x) blend1(row + x, 256, tg.color, tg.alpha);
+    }
+#endif
+}
+
+// Per-sample coverage over [x0,x1) x [y0,y1); a sample counts if it is
+// inside any piece, i.e. on the inner side of all of that piece's edges.
+template <int Samples>
+void coverRect(const Target& tg, const LocalPieces& lp, int x0, int x1, int y0, int y1) {
+    const int (*offsets)[2] = Samples == 4 ? kAaOffsets : kCentreOffset;
+    const int shift = Samples == 4 ? 6 : 8; // samples inside -> coverage 0..256
+#ifdef SOFTRASTER_SSE2
+    const int n = lp.count;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i src16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(tg.color)), zero);
+    const __m128i alpha32 = _mm_set1_epi32(static_cast<int>(tg.alpha));
+    __m128i rowE[SoftRaster::kMaxEdges], stepX[SoftRaster::kMaxEdges], stepY[SoftRaster::kMaxEdges];
+    __m128i off[SoftRaster::kMaxEdges][Samples];
+    for (int i = 0; i < n; ++i) {
+        const LocalEdge& le = lp.edges[i];
+        const int dx = le.a * kSub;
+        rowE[i] = _mm_add_epi32(_mm_set1_epi32(le.e), _mm_set_epi32(3 * dx, 2 * dx, dx, 0));
+        stepX[i] = _mm_set1_epi32(4 * dx);
+        stepY[i] = _mm_set1_epi32(le.b * kSub);
+        for (int k = 0; k < Samples; ++k)
+            off[i][k] = _mm_set1_epi32(le.a * offsets[k][0] + le.b * offsets[k][1]);
+    }
+    for (int y = y0; y < y1; ++y) {
+        uint32_t* row = tg.pixels + static_cast<size_t>(y) * tg.stride;
+        __m128i cur[SoftRaster::kMaxEdges];
+        for (int i = 0; i < n; ++i) cur[i] = rowE[i];
+        for (int x = x0 & ~3; x < x1; x += 4) {
+            __m128i cov = zero;
+            for (int k = 0; k < Samples; ++k) {
+                // the sign bit of the OR of a piece's edge values says "outside"
+                __m128i outside = _mm_set1_epi32(-1);
+                for (int p = 0, i = 0; p < lp.pieces; ++p) {
+                    __m128i v = _mm_add_epi32(cur[i], off[i][k]);
+                    for (++i; i < lp.end[p]; ++i) v = _mm_or_si128(v, _mm_add_epi32(cur[i], off[i][k]));
+                    outside = _mm_and_si128(outside, _mm_srai_epi32(v, 31));
+                }
+                cov = _mm_add_epi32(cov, _mm_add_epi32(one, outside));
+            }
+            // lanes outside [x0, x1) lie outside the shape's bounds, so they
+            // come out uncovered without masking
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(cov, zero)) != 0xFFFF)
+                blend4(row + x, _mm_slli_epi32(cov, shift), src16, alpha32);
+            for (int i = 0; i < n; ++i) cur[i] = _mm_add_epi32(cur[i], stepX[i]);
+        }
+        for (int i = 0; i < n; ++i) rowE[i] = _mm_add_epi32(rowE[i], stepY[i]);
+    }
+#else
+    const int gx0 = x0 & ~3;
+    for (int y = y0; y < y1; ++y) {
+        uint32_t* row = tg.pixels + static_cast<size_t>(y) * tg.stride;
+        for (int x = x0; x < x1; ++x) {
+            uint32_t cov = 0;
+            for (int k = 0; k < Samples; ++k) {
+                const int sx = kSub * (x - gx0) + offsets[k][0], sy = kSub * (y - y0) + offsets[k][1];
+                for (int p = 0, i = 0; p < lp.pieces; i = lp.end[p++]) {
+                    bool in = true;
+                    for (int j = i; j < lp.end[p] && in; ++j)
+                        in = lp.edges[j].e + lp.edges[j].a * sx + lp.edges[j].b * sy >= 0;
+                    if (in) {
+                        ++cov;
+                        break;
+                    }
+                }
+            }
+            if (cov) blend1(row + x, cov << shift, tg.color, tg.alpha);
+        }
+    }
+#endif
+}
+
+} // namespace
+
+bool SoftRaster::init(SDL_Renderer* ren, int w, int h) {
+    shutdown();
+    texture_ = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+    if (!texture_) return false;
+    // Premultiplied "over" where the backend supports custom blend modes
+    // (the software renderer doesn't); otherwise upload straight alpha.
+    SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    premultipliedBlend_ = SDL_SetTextureBlendMode(texture_, premultiplied) == 0;
+    if (!premultipliedBlend_ && SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND) != 0) {
+        shutdown();
+        return false;
+    }
+    w_ = w;
+    h_ = h;
+    stride_ = (w + 3) & ~3; // whole 4-pixel groups on every row
+    tilesX_ = (w + kTile - 1) / kTile;
+    tilesY_ = (h + kTile - 1) / kTile;
+    pixels_.assign(static_cast<size_t>(stride_) * h, 0);
+    bins_.assign(static_cast<size_t>(tilesX_) * tilesY_, std::vector<uint32_t>());
+    dirty_.assign(bins_.size(), 0);
+    // texture contents start undefined: the first present uploads every tile
+    prevDirty_.assign(bins_.size(), 1);
+    return true;
+}
+
+void SoftRaster::shutdown() {
+    if (texture_) SDL_DestroyTexture(texture_);
+    texture_ = nullptr;
+    edges_.clear();
+    pieces_.clear();
+    shapes_.clear();
+    for (auto& bin : bins_) bin.clear();
+}
+
+bool SoftRaster::addPiece(const int32_t* x, const int32_t* y, int count) {
+    int64_t area = 0;
+    for (int i = 0; i < count; ++i) {
+        const int j = (i + 1) % count;
+        area += static_cast<int64_t>(x[i]) * y[j] - static_cast<int64_t>(x[j]) * y[i];
+    }
+    if (area == 0) return false;
+    // wind so that the inside is where every edge function is >= 0
+    const uint32_t first = static_cast<uint32_t>(edges_.size());
+    for (int k = 0; k < count; ++k) {
+        const int i = area > 0 ? k : count - 1 - k;
+        const int j = area > 0 ? (k + 1) % count : (2 * count - 2 - k) % count;
+        Edge ed;
+        ed.a = y[i] - y[j];
+        ed.b = x[j] - x[i];
+        ed.c = -(static_cast<int64_t>(ed.a) * x[i] + static_cast<int64_t>(ed.b) * y[i]);
+        // top-left rule: a sample exactly on an edge shared by two pieces
+        // belongs to one of them only
+        bool topLeft = ed.a > 0 || (ed.a == 0 && ed.b > 0);
+        if (!topLeft) ed.c -= 1;
+        edges_.push_back(ed);
+    }
+    pieces_.push_back(Piece{ first, static_cast<uint32_t>(count) });
+    return true;
+}
+
+void SoftRaster::pushShape(uint32_t firstPiece, SDL_Color color, bool antialias, float minX, float minY, float maxX, float maxY) {
+    Shape s;
+    s.color = premultiply(color);
+    s.alpha = color.a;
+    s.firstPiece = firstPiece;
+    s.pieceCount = static_cast<uint32_t>(pieces_.size()) - firstPiece;
+    s.minX = std::max(0, static_cast<int>(std::floor(minX)));
+    s.minY = std::max(0, static_cast<int>(std::floor(minY)));
+    s.maxX = std::min(w_ - 1, static_cast<int>(std::floor(maxX)));
+    s.maxY = std::min(h_ - 1, static_cast<int>(std::floor(maxY)));
+    s.antialias = antialias;
+    if (s.pieceCount == 0) return;
+    if (s.minX > s.maxX || s.minY > s.maxY) {
+        edges_.resize(pieces_[firstPiece].firstEdge);
+        pieces_.resize(firstPiece);
+        return;
+    }
+    const uint32_t index = static_cast<uint32_t>(shapes_.size());
+    shapes_.push_back(s);
+    for (int ty = s.minY / kTile; ty <= s.maxY / kTile; ++ty)
+        for (int tx = s.minX / kTile; tx <= s.maxX / kTile; ++tx)
+            bins_[static_cast<size_t>(ty) * tilesX_ + tx].push_back(index);
+}
+
+void SoftRaster::fillTriangle(Vec2 a, Vec2 b, Vec2 c, SDL_Color color, bool antialias) {
+    if (!texture_ || color.a == 0) return;
+    const Vec2 v[3] = { a, b, c };
+    int32_t x[3], y[3];
+    for (int i = 0; i < 3; ++i) {
+        // also rejects NaN
+        if (!(std::fabs(v[i].x) < kMaxCoord && std::fabs(v[i].y) < kMaxCoord)) return;
+        x[i] = static_cast<int32_t>(std::lround(v[i].x * kSub));
+        y[i] = static_cast<int32_t>(std::lround(v[i].y * kSub));
+    }
+    const uint32_t first = static_cast<uint32_t>(pieces_.size());
+    if (!addPiece(x, y, 3)) return;
+    pushShape(first, color, antialias,
+        std::min({ a.x, b.x, c.x }), std::min({ a.y, b.y, c.y }),
+        std::max({ a.x, b.x, c.x }), std::max({ a.y, b.y, c.y }));
+}
+
+void SoftRaster::fillPolygon(const Vec2* pts, size_t n, Vec2 center, SDL_Color color, bool antialias) {
+    if (!texture_ || n < 3 || color.a == 0) return;
+    if (!(std::fabs(center.x) < kMaxCoord && std::fabs(center.y) < kMaxCoord)) return;
+    fx_.resize(n);
+    fy_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (!(std::fabs(pts[i].x) < kMaxCoord && std::fabs(pts[i].y) < kMaxCoord)) return;
+        fx_[i] = static_cast<int32_t>(std::lround(pts[i].x * kSub));
+        fy_[i] = static_cast<int32_t>(std::lround(pts[i].y * kSub));
+    }
+    const int32_t cx = static_cast<int32_t>(std::lround(center.x * kSub));
+    const int32_t cy = static_cast<int32_t>(std::lround(center.y * kSub));
+
+    uint32_t firstPiece = static_cast<uint32_t>(pieces_.size());
+    size_t shapeEdges = 0;
+    float minX = center.x, minY = center.y, maxX = center.x, maxY = center.y;
+    for (size_t i = 0; i < n;) {
+        // Grow a convex fan centre, p[i], ..., p[j]: every turn along it
+        // must go the same way as the first triangle's.
+        const int64_t dir = turn(cx, cy, fx_[i], fy_[i], fx_[(i + 1) % n], fy_[(i + 1) % n]);
+        if (dir == 0) { // degenerate sliver, nothing to cover
+            ++i;
+            continue;
+        }
+        size_t j = i + 1;
+        while (j < n && static_cast<int>(j - i) + 2 < kMaxPieceVerts) {
+            const size_t pj = j % n, pk = (j + 1) % n, pp = j - 1;
+            if (turn(fx_[pp], fy_[pp], fx_[pj], fy_[pj], fx_[pk], fy_[pk]) * (dir > 0 ? 1 : -1) < 0) break;
+            if (turn(fx_[pj], fy_[pj], fx_[pk], fy_[pk], cx, cy) * (dir > 0 ? 1 : -1) < 0) break;
+            if (turn(fx_[pk], fy_[pk], cx, cy, fx_[i], fy_[i]) * (dir > 0 ? 1 : -1) <= 0) break;
+            ++j;
+        }
+        const int count = static_cast<int>(j - i) + 2;
+        if (pieces_.size() - firstPiece == static_cast<size_t>(kMaxPieces) || shapeEdges + count > static_cast<size_t>(kMaxEdges)) {
+            pushShape(firstPiece, color, antialias, minX, minY, maxX, maxY);
+            firstPiece = static_cast<uint32_t>(pieces_.size());
+            shapeEdges = 0;
+            minX = maxX = center.x;
+            minY = maxY = center.y;
+        }
+        int32_t x[kMaxPieceVerts], y[kMaxPieceVerts];
+        x[0] = cx;
+        y[0] = cy;
+        for (size_t k = i; k <= j; ++k) {
+            x[k - i + 1] = fx_[k % n];
+            y[k - i + 1] = fy_[k % n];
+            const Vec2& p = pts[k % n];
+            minX = std::min(minX, p.x);
+            maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y);
+            maxY = std::max(maxY, p.y);
+        }
+        if (addPiece(x, y, count)) shapeEdges += count;
+        i = j;
+    }
+    pushShape(firstPiece, color, antialias, minX, minY, maxX, maxY);
+}
+
+void SoftRaster::rasterShapeInTile(const Shape& s, int tx, int ty) {
+    const int px0 = tx * kTile, py0 = ty * kTile;
+    const int x0 = std::max(px0, s.minX), x1 = std::min(std::min(px0 + kTile, w_), s.maxX + 1);
+    const int y0 = std::max(py0, s.minY), y1 = std::min(std::min(py0 + kTile, h_), s.maxY + 1);
+    if (x0 >= x1 || y0 >= y1) return;
+    const Target tg{ pixels_.data(), stride_, s.color, s.alpha, s.antialias };
+
+    // Corner tests over the covered part of the tile: drop a piece that an
+    // edge rejects, drop edges that accept the whole rectangle, keep the
+    // rest. Edge values are 64-bit until an edge is known to cross the
+    // tile; from there they fit in 32 bits relative to it.
+    const int gx0 = x0 & ~3; // tiles start on a 4-pixel group
+    const int64_t sx0 = static_cast<int64_t>(x0) * kSub, sx1 = static_cast<int64_t>(x1) * kSub;
+    const int64_t sy0 = static_cast<int64_t>(y0) * kSub, sy1 = static_cast<int64_t>(y1) * kSub;
+    LocalPieces tile;
+    for (uint32_t pi = 0; pi < s.pieceCount; ++pi) {
+        const Piece& piece = pieces_[s.firstPiece + pi];
+        const int start = tile.count;
+        bool reject = false;
+        for (uint32_t k = 0; k < piece.edgeCount && !reject; ++k) {
+            const Edge& ed = edges_[piece.firstEdge + k];
+            const int64_t hi = ed.c + ed.a * (ed.a > 0 ? sx1 : sx0) + ed.b * (ed.b > 0 ? sy1 : sy0);
+            const int64_t lo = ed.c + ed.a * (ed.a > 0 ? sx0 : sx1) + ed.b * (ed.b > 0 ? sy0 : sy1);
+            if (hi < 0) reject = true;
+            else if (lo < 0)
+                tile.edges[tile.count++] = LocalEdge{ ed.a, ed.b,
+                    static_cast<int32_t>(ed.c + ed.a * (static_cast<int64_t>(gx0) * kSub + kSub / 2)
+                                              + ed.b * (static_cast<int64_t>(y0) * kSub + kSub / 2)) };
+        }
+        if (reject) {
+            tile.count = start;
+            continue;
+        }
+        if (tile.count == start) { // the piece covers the whole rectangle
+            fillRect(tg, x0, x1, y0, y1);
+            return;
+        }
+        tile.end[tile.pieces++] = tile.count;
+    }
+    if (tile.pieces == 0) return;
+
+    // Same again per 8x8 block, so big shapes fill their interior blocks
+    // directly and edge blocks only test the edges that reach them.
+    for (int by = y0; by < y1; by = (by & ~(kBlock - 1)) + kBlock) {
+        const int by1 = std::min(y1, (by & ~(kBlock - 1)) + kBlock);
+        for (int bx = x0; bx < x1; bx = (bx & ~(kBlock - 1)) + kBlock) {
+            const int bx1 = std::min(x1, (bx & ~(kBlock - 1)) + kBlock);
+            // block rectangle in samples, relative to the tile's first centre
+            const int32_t rx0 = (bx - gx0) * kSub - kSub / 2, rx1 = (bx1 - gx0) * kSub - kSub / 2;
+            const int32_t ry0 = (by - y0) * kSub - kSub / 2, ry1 = (by1 - y0) * kSub - kSub / 2;
+            const int32_t shiftX = ((bx & ~3) - gx0) * kSub, shiftY = (by - y0) * kSub;
+            LocalPieces block;
+            bool full = false;
+            for (int p = 0, i = 0; p < tile.pieces && !full; i = tile.end[p++]) {
+                const int start = block.count;
+                bool reject = false;
+                for (int j = i; j < tile.end[p] && !reject; ++j) {
+                    const LocalEdge& le = tile.edges[j];
+                    const int32_t hi = le.e + le.a * (le.a > 0 ? rx1 : rx0) + le.b * (le.b > 0 ? ry1 : ry0);
+                    const int32_t lo = le.e + le.a * (le.a > 0 ? rx0 : rx1) + le.b * (le.b > 0 ? ry0 : ry1);
+                    if (hi < 0) reject = true;
+                    else if (lo < 0) block.edges[block.count++] = LocalEdge{ le.a, le.b, le.e + le.a * shiftX + le.b * shiftY };
+                }
+                if (reject) block.count = start;
+                else if (block.count == start) full = true;
+                else block.end[block.pieces++] = block.count;
+            }
+            if (full) fillRect(tg, bx, bx1, by, by1);
+            else if (block.pieces > 0 && s.antialias) coverRect<4>(tg, block, bx, bx1, by, by1);
+            else if (block.pieces > 0) coverRect<1>(tg, block, bx, bx1, by, by1);
+        }
+    }
+}
+
+bool SoftRaster::upload() {
+    // last frame's tiles are rewritten too, so whatever left them is erased
+    const SDL_Rect r = dirtyBounds(dirty_, &prevDirty_, tilesX_, kTile, w_, h_);
+    if (r.w <= 0 || r.h <= 0) return true;
+    void* dst = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(texture_, &r, &dst, &pitch) != 0) return false;
+    static uint32_t recip[256]; // 255/a in 16.16, for straight-alpha uploads
+    if (!premultipliedBlend_ && recip[1] == 0)
+        for (uint32_t a = 1; a < 256; ++a) recip[a] = (255u << 16) / a;
+    for (int y = 0; y < r.h; ++y) {
+        const uint32_t* src = &pixels_[static_cast<size_t>(r.y + y) * stride_ + r.x];
+        uint32_t* out = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(dst) + static_cast<size_t>(y) * pitch);
+        if (premultipliedBlend_) {
+            std::copy(src, src + r.w, out);
+            continue;
+        }
+        for (int x = 0; x < r.w; ++x) {
+            const uint32_t p = src[x], a = p >> 24;
+            if (a == 0 || a == 255) {
+                out[x] = p;
+                continue;
+            }
+            const uint32_t rc = (((p >> 16) & 0xFF) * recip[a]) >> 16;
+            const uint32_t gc = (((p >> 8) & 0xFF) * recip[a]) >> 16;
+            const uint32_t bc = ((p & 0xFF) * recip[a]) >> 16;
+            out[x] = (a << 24) | (std::min(rc, 255u) << 16) | (std::min(gc, 255u) << 8) | std::min(bc, 255u);
+        }
+    }
+    SDL_UnlockTexture(texture_);
+    return true;
+}
+
+bool SoftRaster::present(SDL_Renderer* ren) {
+    if (!texture_) return false;
+    // clear what was drawn last frame
+    for (int ty = 0; ty < tilesY_; ++ty) {
+        for (int tx = 0; tx < tilesX_; ++tx) {
+            if (!prevDirty_[static_cast<size_t>(ty) * tilesX_ + tx]) continue;
+            const int x0 = tx * kTile, x1 = std::min(x0 + kTile, w_);
+            for (int y = ty * kTile; y < std::min((ty + 1) * kTile, h_); ++y) {
+                uint32_t* row = &pixels_[static_cast<size_t>(y) * stride_];
+                std::fill(row + x0, row + x1, 0u);
+            }
+        }
+    }
+    // rasterize tile by tile, shapes in submission order within each tile
+    for (int ty = 0; ty < tilesY_; ++ty) {
+        for (int tx = 0; tx < tilesX_; ++tx) {
+            const size_t i = static_cast<size_t>(ty) * tilesX_ + tx;
+            if (bins_[i].empty()) continue;
+            for (uint32_t si : bins_[i]) rasterShapeInTile(shapes_[si], tx, ty);
+            bins_[i].clear();
+            dirty_[i] = 1;
+        }
+    }
+    bool copied = false;
+    if (upload()) {
+        const SDL_Rect r = dirtyBounds(dirty_, nullptr, tilesX_, kTile, w_, h_);
+        if (r.w > 0 && r.h > 0) copied = SDL_RenderCopy(ren, texture_, &r, &r) == 0;
+        prevDirty_.swap(dirty_);
+    } else {
+        // keep both sets pending so the next successful upload repairs them
+        for (size_t i = 0; i < dirty_.size(); ++i) prevDirty_[i] = prevDirty_[i] | dirty_[i];
+    }
+    std::fill(dirty_.begin(), dirty_.end(), 0);
+    edges_.clear();
+    pieces_.clear();
+    shapes_.clear();
+    return copied;
+}
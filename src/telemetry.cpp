@@ -0,0 +1,214 @@
+#include "telemetry.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+uint32_t currentPid() { return static_cast<uint32_t>(GetCurrentProcessId()); }
+#else
+uint32_t currentPid() { return static_cast<uint32_t>(getpid()); }
+#endif
+
+// A fresh mapping is zero-filled, so a non-zero magic means someone has
+// used this name before.
+bool ownedByLiveGame(const TelemetryLayout* b) {
+    if (b->magic.load(std::memory_order_acquire) != kTelemetryMagic) return false;
+    uint32_t pid = b->writerPid.load(std::memory_order_relaxed);
+    return pid != 0 && pid != currentPid() && pidAlive(pid);
+}
+
+void initBlock(TelemetryLayout* b) {
+    b->magic.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // readers that mapped a stale segment see seq restart from 0, which is
+    // just another change of seq to them
+    std::memset(reinterpret_cast<char*>(b) + sizeof(b->magic), 0, sizeof(TelemetryLayout) - sizeof(b->magic));
+    b->version = kTelemetryVersion;
+    b->layoutBytes = static_cast<uint32_t>(sizeof(TelemetryLayout));
+    b->writerPid.store(currentPid(), std::memory_order_relaxed);
+    b->magic.store(kTelemetryMagic, std::memory_order_release);
+}
+
+bool validBlock(const TelemetryLayout* b) {
+    return b->magic.load(std::memory_order_acquire) == kTelemetryMagic
+        && b->version == kTelemetryVersion
+        && b->layoutBytes == sizeof(TelemetryLayout);
+}
+
+} // namespace
+
+#ifdef _WIN32
+bool pidAlive(uint32_t pid) {
+    HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    if (!h) return false;
+    bool alive = WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+    CloseHandle(h);
+    return alive;
+}
+#else
+// EPERM: the process exists but belongs to another user
+bool pidAlive(uint32_t pid) { return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM; }
+#endif
+
+#ifdef _WIN32
+
+bool TelemetryWriter::open(const char* name) {
+    close();
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(TelemetryLayout), name);
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, sizeof(TelemetryLayout));
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    TelemetryLayout* b = static_cast<TelemetryLayout*>(view);
+    if (ownedByLiveGame(b)) {
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+    initBlock(b);
+    block_ = b;
+    handle_ = mapping;
+    return true;
+}
+
+void TelemetryWriter::close() {
+    if (!block_) return;
+    block_->writerPid.store(0, std::memory_order_release);
+    UnmapViewOfFile(block_);
+    CloseHandle(static_cast<HANDLE>(handle_));
+    block_ = nullptr;
+    handle_ = nullptr;
+}
+
+bool TelemetryReader::open(const char* name) {
+    close();
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(TelemetryLayout));
+    if (!view || !validBlock(static_cast<const TelemetryLayout*>(view))) {
+        if (view) UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+    block_ = static_cast<const TelemetryLayout*>(view);
+    handle_ = mapping;
+    return true;
+}
+
+void TelemetryReader::close() {
+    if (!block_) return;
+    UnmapViewOfFile(block_);
+    CloseHandle(static_cast<HANDLE>(handle_));
+    block_ = nullptr;
+    handle_ = nullptr;
+}
+
+#else
+
+bool TelemetryWriter::open(const char* name) {
+    close();
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, sizeof(TelemetryLayout)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* m = mmap(nullptr, sizeof(TelemetryLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the segment alive
+    if (m == MAP_FAILED) return false;
+    TelemetryLayout* b = static_cast<TelemetryLayout*>(m);
+    if (ownedByLiveGame(b)) {
+        munmap(m, sizeof(TelemetryLayout));
+        return false;
+    }
+    initBlock(b);
+    block_ = b;
+    snprintf(name_, sizeof(name_), "%s", name);
+    return true;
+}
+
+void TelemetryWriter::close() {
+    if (!block_) return;
+    block_->writerPid.store(0, std::memory_order_release);
+    munmap(block_, sizeof(TelemetryLayout));
+    // readers that still have it mapped keep their view of the final frame
+    shm_unlink(name_);
+    block_ = nullptr;
+}
+
+bool TelemetryReader::open(const char* name) {
+    close();
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return false;
+    void* m = mmap(nullptr, sizeof(TelemetryLayout), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (m == MAP_FAILED) return false;
+    if (!validBlock(static_cast<const TelemetryLayout*>(m))) {
+        munmap(m, sizeof(TelemetryLayout));
+        return false;
+    }
+    block_ = static_cast<const TelemetryLayout*>(m);
+    return true;
+}
+
+void TelemetryReader::close() {
+    if (!block_) return;
+    munmap(const_cast<TelemetryLayout*>(block_), sizeof(TelemetryLayout));
+    block_ = nullptr;
+}
+
+#endif
+
+bool TelemetryReader::read(TelemetrySample& out) const {
+    if (!block_) return false;
+    const TelemetryLayout* b = block_;
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        uint32_t before = b->seq.load(std::memory_order_acquire);
+        if (before & 1u) continue; // write in progress
+        TelemetrySample s;
+        s.frame = b->frame.load(std::memory_order_relaxed);
+        s.tick = b->tick.load(std::memory_order_relaxed);
+        s.timestampUs = b->timestampUs.load(std::memory_order_relaxed);
+        s.allocations = b->allocations.load(std::memory_order_relaxed);
+        s.frameUs = b->frameUs.load(std::memory_order_relaxed);
+        s.workUs = b->workUs.load(std::memory_order_relaxed);
+        s.asteroids = b->asteroids.load(std::memory_order_relaxed);
+        s.sparks = b->sparks.load(std::memory_order_relaxed);
+        s.shootingStars = b->shootingStars.load(std::memory_order_relaxed);
+        s.drawCalls = b->drawCalls.load(std::memory_order_relaxed);
+        s.frameAllocations = b->frameAllocations.load(std::memory_order_relaxed);
+        s.audioDeadlineMisses = b->audioDeadlineMisses.load(std::memory_order_relaxed);
+        uint32_t settings = b->settings.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (b->seq.load(std::memory_order_relaxed) != before) continue; // torn, retry
+        s.shootingStarsEnabled = (settings & TelemetryShootingStars) ? 1 : 0;
+        s.statsEnabled = (settings & TelemetryStats) ? 1 : 0;
+        s.menuOpen = (settings & TelemetryMenuOpen) ? 1 : 0;
+        s.starTwinklePreset = static_cast<uint8_t>(settings >> 8);
+        out = s;
+        return true;
+    }
+    return false;
+}
+
+uint32_t TelemetryReader::writerPid() const {
+    return block_ ? block_->writerPid.load(std::memory_order_acquire) : 0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Live counters in a named shared-memory segment (POSIX shm_open, or a named
+// file mapping on Windows) for monitoring a running game from outside.
+//
+// The segment holds one `TelemetryLayout`. The game is the only writer and
+// publishes once per frame under a sequence lock: `seq` is odd while a write
+// is in progress, and a reader retries whenever it saw an odd value or `seq`
+// changed during its copy. The writer never waits, so a slow or stuck reader
+// cannot stall the frame loop. Every field is a fixed-width integer so the
+// layout is identical for any compiler; bump `kTelemetryVersion` on change.
+
+const uint32_t kTelemetryMagic = 0x4D4C4554; // "TELM" on disk (little-endian)
+const uint32_t kTelemetryVersion = 1;
+#ifdef _WIN32
+const char* const kTelemetryDefaultName = "Local\\starboy_telemetry";
+#else
+const char* const kTelemetryDefaultName = "/starboy_telemetry";
+#endif
+
+// One published frame, as plain values.
+struct TelemetrySample {
+    uint64_t frame = 0;          // frames since start
+    uint64_t tick = 0;           // world tick (goes backwards while rewinding)
+    uint64_t timestampUs = 0;    // monotonic clock at publish time
+    uint32_t frameUs = 0;        // full frame time including the frame cap
+    uint32_t workUs = 0;         // time spent before the frame cap sleep
+    uint32_t asteroids = 0;
+    uint32_t sparks = 0;
+    uint32_t shootingStars = 0;
+    uint32_t drawCalls = 0;      // SDL render calls this frame
+    uint64_t allocations = 0;    // operator new calls since start
+    uint32_t frameAllocations = 0;
+    uint32_t audioDeadlineMisses = 0;
+    // settings state
+    uint8_t shootingStarsEnabled = 0;
+    uint8_t starTwinklePreset = 0;
+    uint8_t statsEnabled = 0;
+    uint8_t menuOpen = 0;
+};
+
+struct alignas(64) TelemetryLayout {
+    // written once at creation (magic last); `writerPid` is cleared when
+    // the game exits
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t layoutBytes;
+    std::atomic<uint32_t> writerPid;
+    alignas(64) std::atomic<uint32_t> seq;
+    std::atomic<uint64_t> frame;
+    std::atomic<uint64_t> tick;
+    std::atomic<uint64_t> timestampUs;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint32_t> frameUs;
+    std::atomic<uint32_t> workUs;
+    std::atomic<uint32_t> asteroids;
+    std::atomic<uint32_t> sparks;
+    std::atomic<uint32_t> shootingStars;
+    std::atomic<uint32_t> drawCalls;
+    std::atomic<uint32_t> frameAllocations;
+    std::atomic<uint32_t> audioDeadlineMisses;
+    std::atomic<uint32_t> settings; // TelemetrySettings bits, preset in 8..15
+};
+
+enum TelemetrySettings : uint32_t {
+    TelemetryShootingStars = 1u << 0,
+    TelemetryStats = 1u << 1,
+    TelemetryMenuOpen = 1u << 2,
+};
+
+// Cross-process atomics must not fall back to a lock inside the runtime.
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "telemetry needs lock-free 32-bit atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "telemetry needs lock-free 64-bit atomics");
+
+// Game side: creates the segment and publishes into it.
+class TelemetryWriter {
+public:
+    TelemetryWriter() = default;
+    ~TelemetryWriter() { close(); }
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    // Create (or take over) the segment `name`. Returns false if shared
+    // memory is unavailable; publish() is then a no-op.
+    bool open(const char* name = kTelemetryDefaultName);
+    void close();
+    bool isOpen() const { return block_ != nullptr; }
+
+    // Wait-free: a fixed sequence of relaxed stores between two seq bumps.
+    void publish(const TelemetrySample& s) {
+        if (!block_) return;
+        const uint32_t seq = block_->seq.load(std::memory_order_relaxed);
+        block_->seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        block_->frame.store(s.frame, std::memory_order_relaxed);
+        block_->tick.store(s.tick, std::memory_order_relaxed);
+        block_->timestampUs.store(s.timestampUs, std::memory_order_relaxed);
+        block_->allocations.store(s.allocations, std::memory_order_relaxed);
+        block_->frameUs.store(s.frameUs, std::memory_order_relaxed);
+        block_->workUs.store(s.workUs, std::memory_order_relaxed);
+        block_->asteroids.store(s.asteroids, std::memory_order_relaxed);
+        block_->sparks.store(s.sparks, std::memory_order_relaxed);
+        block_->shootingStars.store(s.shootingStars, std::memory_order_relaxed);
+        block_->drawCalls.store(s.drawCalls, std::memory_order_relaxed);
+        block_->frameAllocations.store(s.frameAllocations, std::memory_order_relaxed);
+        block_->audioDeadlineMisses.store(s.audioDeadlineMisses, std::memory_order_relaxed);
+        block_->settings.store((s.shootingStarsEnabled ? TelemetryShootingStars : 0u)
+            | (s.statsEnabled ? TelemetryStats : 0u)
+            | (s.menuOpen ? TelemetryMenuOpen : 0u)
+            | (static_cast<uint32_t>(s.starTwinklePreset) << 8), std::memory_order_relaxed);
+        block_->seq.store(seq + 2, std::memory_order_release);
+    }
+
+private:
+    TelemetryLayout* block_ = nullptr;
+    void* handle_ = nullptr; // Windows mapping handle
+    char name_[64] = {};
+};
+
+// True while process `pid` is running. The game clears `writerPid` on a
+// clean exit; a crash leaves it set, so monitors check this as well.
+bool pidAlive(uint32_t pid);
+
+// Monitor side: maps an existing segment read-only.
+class TelemetryReader {
+public:
+    TelemetryReader() = default;
+    ~TelemetryReader() { close(); }
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    // False if the segment does not exist or has the wrong magic/version.
+    bool open(const char* name = kTelemetryDefaultName);
+    void close();
+    // Copy a consistent sample. Returns false if the writer kept the lock
+    // for the whole retry budget (it only holds it for a few stores).
+    bool read(TelemetrySample& out) const;
+    // Process id of the game, or 0 once it has exited.
+    uint32_t writerPid() const;
+
+private:
+    const TelemetryLayout* block_ = nullptr;
+    void* handle_ = nullptr;
+};
@@ -0,0 +1,96 @@
+// starboy_telemetry: tails the live counters a running game publishes with
+// --telemetry. No SDL dependency, so it runs anywhere the game does.
+//
+//   starboy_telemetry [--name=SEGMENT] [--interval=MS] [--once]
+#include "telemetry.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static void printHeader() {
+    printf("%10s %8s %8s %8s %7s %6s %6s %5s %6s %8s %6s  %s\n",
+        "frame", "tick", "frame_ms", "work_ms", "fps", "asts", "sparks", "shoot", "draws", "allocs/f", "amiss", "settings");
+}
+
+static void printSample(const TelemetrySample& s, double fps) {
+    printf("%10llu %8llu %8.2f %8.2f %7.1f %6u %6u %5u %6u %8u %6u  stars:%s twinkle:%u stats:%s menu:%s\n",
+        (unsigned long long)s.frame, (unsigned long long)s.tick, s.frameUs / 1000.0, s.workUs / 1000.0, fps,
+        s.asteroids, s.sparks, s.shootingStars, s.drawCalls, s.frameAllocations, s.audioDeadlineMisses,
+        s.shootingStarsEnabled ? "on" : "off", static_cast<unsigned>(s.starTwinklePreset),
+        s.statsEnabled ? "on" : "off", s.menuOpen ? "open" : "closed");
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    const char* name = kTelemetryDefaultName;
+    int intervalMs = 500;
+    bool once = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--name=", 7) == 0) name = argv[i] + 7;
+        else if (strncmp(argv[i], "--interval=", 11) == 0) intervalMs = atoi(argv[i] + 11);
+        else if (strcmp(argv[i], "--once") == 0) once = true;
+        else {
+            fprintf(stderr, "usage: %s [--name=SEGMENT] [--interval=MS] [--once]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (intervalMs < 10) intervalMs = 10;
+
+    TelemetryReader reader;
+    bool waiting = false;
+    while (!reader.open(name)) {
+        if (once) {
+            fprintf(stderr, "no telemetry segment %s (is the game running with --telemetry?)\n", name);
+            return 1;
+        }
+        if (!waiting) fprintf(stderr, "waiting for %s...\n", name);
+        waiting = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+
+    printHeader();
+    TelemetrySample prev;
+    bool havePrev = false;
+    int rows = 0;
+    // a crashed game leaves its pid and last frame behind; give up once
+    // the frame counter has been frozen this long
+    const int stallMs = intervalMs * 5 > 5000 ? intervalMs * 5 : 5000;
+    int stalledMs = 0;
+    for (;;) {
+        TelemetrySample s;
+        if (!reader.read(s)) {
+            fprintf(stderr, "telemetry: writer held the lock too long, skipping\n");
+        } else if (!havePrev || s.frame != prev.frame) {
+            // fps from the game's own clock, so reader jitter doesn't show
+            double fps = 0.0;
+            if (havePrev && s.timestampUs > prev.timestampUs)
+                fps = (s.frame - prev.frame) * 1e6 / (s.timestampUs - prev.timestampUs);
+            else if (s.frameUs > 0)
+                fps = 1e6 / s.frameUs;
+            printSample(s, fps);
+            if (++rows % 40 == 0) printHeader();
+            prev = s;
+            havePrev = true;
+            stalledMs = 0;
+        } else {
+            stalledMs += intervalMs;
+        }
+        if (once) return 0;
+        const uint32_t pid = reader.writerPid();
+        if (pid == 0) {
+            printf("game exited\n");
+            return 0;
+        }
+        if (!pidAlive(pid)) {
+            printf("game exited without closing telemetry\n");
+            return 0;
+        }
+        if (stalledMs >= stallMs) {
+            printf("no new frames for %d ms, giving up\n", stalledMs);
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+}
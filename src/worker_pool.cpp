@@ -0,0 +1,58 @@
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (unsigned i = 1; i < threads; ++i) workers_.emplace_back([this]() { workerLoop(); });
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+void WorkerPool::drain() {
+    for (size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < jobSize_; i = next_.fetch_add(1, std::memory_order_relaxed)) {
+        (*job_)(i);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            wake_.wait(lock, [&]() { return quit_ || generation_ != seen; });
+            if (quit_) return;
+            seen = generation_;
+        }
+        drain();
+        std::lock_guard<std::mutex> lock(m_);
+        if (--busy_ == 0) done_.notify_one();
+    }
+}
+
+void WorkerPool::run(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        job_ = &fn;
+        jobSize_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        busy_ = static_cast<unsigned>(workers_.size());
+        ++generation_;
+    }
+    wake_.notify_all();
+    drain();
+    std::unique_lock<std::mutex> lock(m_);
+    done_.wait(lock, [&]() { return busy_ == 0; });
+    job_ = nullptr;
+}
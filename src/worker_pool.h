@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Minimal persistent thread pool for data-parallel loops. Workers sleep on a
+// condition variable between jobs; the calling thread takes part in each job.
+// Work items are handed out dynamically, so callers must make every item
+// independent of which thread runs it.
+class WorkerPool {
+public:
+    // `threads` counts the calling thread; 0 picks hardware_concurrency().
+    explicit WorkerPool(unsigned threads = 0);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Call fn(i) for every i in [0, count) and return when all are done.
+    void run(size_t count, const std::function<void(size_t)>& fn);
+    unsigned threads() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> workers_;
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t jobSize_ = 0;
+    std::atomic<size_t> next_{ 0 };
+    unsigned generation_ = 0;
+    unsigned busy_ = 0;
+    bool quit_ = false;
+};
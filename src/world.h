@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct Vec2 {
+    float x;
+    float y;
+};
+
+static inline float wrap(float v, float a, float b) {
+    float w = b - a;
+    while (v < a) v += w;
+    while (v >= b) v -= w;
+    return v;
+}
+
+struct Asteroid {
+    Vec2 pos;
+    std::vector<Vec2> shape; // relative
+    float radius; // approximate collision radius
+    Vec2 vel{0.0f, 0.0f};
+};
+
+// Visual event: short bright spark (pop) and moving shooting star
+struct Spark {
+    Vec2 pos;
+    float life = 0.0f;
+    float maxLife = 0.2f;
+    float size = 2.0f;
+};
+
+struct ShootingStar {
+    Vec2 pos;
+    Vec2 vel;
+    float life = 0.0f;
+    float maxLife = 1.2f;
+    float length = 40.0f; // trail length
+};
+
+// Small PCG32 generator. Its whole state is two integers, so it can be
+// snapshotted byte-for-byte (std::mt19937 carries ~2.5KB of state).
+// Satisfies UniformRandomBitGenerator so std:: distributions accept it.
+struct Pcg32 {
+    using result_type = uint32_t;
+    uint64_t state = 0;
+    uint64_t inc = 0;
+
+    explicit Pcg32(uint64_t seed = 0x853c49e6748fea9bULL, uint64_t seq = 0xda3e39cb94b95bdbULL) { reseed(seed, seq); }
+    void reseed(uint64_t seed, uint64_t seq = 0xda3e39cb94b95bdbULL) {
+        state = 0;
+        inc = (seq << 1u) | 1u;
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xffffffffu; }
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+};
+
+// Everything that evolves during play. Background stars are regenerated from
+// a fixed seed and settings live in starboy_settings.txt, so neither is here.
+struct World {
+    uint64_t tick = 0;
+    Vec2 shipPos{ 0.0f, 0.0f };
+    float shipAngle = 0.0f; // radians
+    Vec2 shipVel{ 0.0f, 0.0f };
+    float collisionFlash = 0.0f; // seconds to show collision flash
+    std::vector<Asteroid> asts;
+    std::vector<Spark> sparks;
+    std::vector<ShootingStar> shootingStars;
+    Pcg32 rng; // runtime visual events
+};